@@ -1102,8 +1102,11 @@ when defined(useNodeIds):
   const nodeIdToDebug* = -1 # 2322968
   var gNodeId: int
 
+var nodesAllocated*: int ## the number of nodes created, for `--profileCompiler`
+
 template newNodeImpl(info2) =
   result = PNode(kind: kind, info: info2)
+  inc nodesAllocated
   when false:
     # this would add overhead, so we skip it; it results in a small amount of leaked entries
     # for old PNode that gets re-allocated at the same address as a PNode that
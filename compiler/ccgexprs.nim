@@ -3185,11 +3185,13 @@ proc expr(p: BProc, n: PNode, d: var TLoc) =
       elif prc.skipGenericOwner.kind == skModule and sfCompileTime notin prc.flags:
         if ({sfExportc, sfCompilerProc} * prc.flags == {sfExportc}) or
             (sfExportc in prc.flags and lfExportLib in prc.loc.flags) or
-            (prc.kind == skMethod):
+            (prc.kind == skMethod and not p.config.usesVTables):
           # due to a bug/limitation in the lambda lifting, unused inner procs
           # are not transformed correctly. We work around this issue (#411) here
           # by ensuring it's no inner proc (owner is a module).
           # Generate proc even if empty body, bugfix #11651.
+          # With vtables a method is only generated together with the RTTI
+          # of a type that can dispatch to it, see `genVTable`.
           genProc(p.module, prc)
   of nkParForStmt: genParForStmt(p, n)
   of nkState: genState(p, n)
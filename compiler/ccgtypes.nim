@@ -379,6 +379,17 @@ proc addForwardStructFormat(m: BModule; structOrUnion: Rope, typename: Rope) =
   else:
     m.s[cfsForwardTypes].addf "typedef $1 $2 $2;$n", [structOrUnion, typename]
 
+proc addTypeDecl(m: BModule; section: TCFileSection; name: Rope; decl: Builder) =
+  ## Adds the definition of the C type `name`. With `--cUnity` the C files
+  ## of several modules end up in one translation unit, so the definition
+  ## is guarded against the copies of the other modules.
+  if m.config.cUnity > 0:
+    m.s[section].addf("#ifndef NIM_TYPE_$1$n#define NIM_TYPE_$1$n", [name])
+    m.s[section].add(decl)
+    m.s[section].add("#endif\n")
+  else:
+    m.s[section].add(decl)
+
 proc seqStar(m: BModule): string =
   if optSeqDestructors in m.config.globalOptions: result = ""
   else: result = "*"
@@ -434,7 +445,7 @@ proc getTypeDescWeak(m: BModule; t: PType; check: var IntSet; kind: TypeDescKind
         struct.addSimpleStruct(m, name = result, baseType = ""):
           struct.addField(name = "len", typ = "NI")
           struct.addField(name = "p", typ = ptrType(result & "_Content"))
-        m.s[cfsTypes].add(struct)
+        addTypeDecl(m, cfsTypes, result, struct)
         pushType(m, t)
     else:
       result = getTypeForward(m, t, sig) & seqStar(m)
@@ -459,7 +470,7 @@ proc seqV2ContentType(m: BModule; t: PType; check: var IntSet) =
       struct.addField(name = "data",
         typ = getTypeDescAux(m, t.skipTypes(abstractInst)[0], check, dkVar),
         isFlexArray = true)
-    m.s[cfsTypes].add(struct)
+    addTypeDecl(m, cfsTypes, result & "_Content", struct)
 
 proc paramStorageLoc(param: PSym): TStorageLoc =
   if param.typ.skipTypes({tyVar, tyLent, tyTypeDesc}).kind notin {
@@ -852,7 +863,7 @@ proc getOpenArrayDesc(m: BModule; t: PType, check: var IntSet; kind: TypeDescKin
         typedef.addSimpleStruct(m, name = "", baseType = ""):
           typedef.addField(name = "Field0", typ = ptrType(elemType))
           typedef.addField(name = "Field1", typ = "NI")
-      m.s[cfsTypes].add(typedef)
+      addTypeDecl(m, cfsTypes, result, typedef)
 
 proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDescKind): Rope =
   # returns only the type's name
@@ -945,7 +956,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
             typedef.addTypedef(name = result):
               typedef.add("NI64")
           else: internalError(m.config, t.sym.info, "getTypeDescAux: enum")
-        m.s[cfsTypes].add(typedef)
+        addTypeDecl(m, cfsTypes, result, typedef)
         when false:
           let owner = hashOwner(t.sym)
           if not gDebugInfo.hasEnum(t.sym.name.s, t.sym.info.line, owner):
@@ -972,7 +983,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
             typedef.addField(name = desc, typ =
               procPtrType(ccNimCall, rettype = rettype, name = "ClP_0"))
             typedef.addField(name = "ClE_0", typ = "void*")
-      m.s[cfsTypes].add(typedef)
+      addTypeDecl(m, cfsTypes, result, typedef)
   of tySequence:
     if optSeqDestructors in m.config.globalOptions:
       result = getTypeDescWeak(m, t, check, kind)
@@ -996,7 +1007,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
               name = "data",
               typ = getTypeDescAux(m, t.elementType, check, kind),
               isFlexArray = true)
-          m.s[cfsSeqTypes].add struct
+          addTypeDecl(m, cfsSeqTypes, result, struct)
         else:
           result = rope("TGenericSeq")
       result.add(seqStar(m))
@@ -1008,7 +1019,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
       var typedef = newBuilder("")
       typedef.addArrayTypedef(name = result, len = 1):
         typedef.add(foo)
-      m.s[cfsTypes].add(typedef)
+      addTypeDecl(m, cfsTypes, result, typedef)
   of tyArray:
     var n: BiggestInt = toInt64(lengthOrd(m.config, t))
     if n <= 0: n = 1   # make an array of at least one element
@@ -1019,7 +1030,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
       var typedef = newBuilder("")
       typedef.addArrayTypedef(name = result, len = n):
         typedef.add(e)
-      m.s[cfsTypes].add(typedef)
+      addTypeDecl(m, cfsTypes, result, typedef)
   of tyObject, tyTuple:
     let tt = origTyp.skipTypes({tyDistinct})
     if isImportedCppType(t) and tt.kind == tyGenericInst:
@@ -1082,7 +1093,7 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
         let recdesc = if t.kind != tyTuple: getRecordDesc(m, t, result, check)
                       else: getTupleDesc(m, t, result, check)
         if not isImportedType(t):
-          m.s[cfsTypes].add(recdesc)
+          addTypeDecl(m, cfsTypes, result, recdesc)
         elif tfIncompleteStruct notin t.flags:
           discard # addAbiCheck(m, t, result) # already handled elsewhere
   of tySet:
@@ -1093,13 +1104,15 @@ proc getTypeDescAux(m: BModule; origTyp: PType, check: var IntSet; kind: TypeDes
     m.typeCache[sig] = result
     if not isImportedType(t):
       let s = int(getSize(m.config, t))
+      var typedef = newBuilder("")
       case s
       of 1, 2, 4, 8:
-        m.s[cfsTypes].addTypedef(name = result):
-          m.s[cfsTypes].add("NU" & rope(s*8))
+        typedef.addTypedef(name = result):
+          typedef.add("NU" & rope(s*8))
       else:
-        m.s[cfsTypes].addArrayTypedef(name = result, len = s):
-          m.s[cfsTypes].add("NU8")
+        typedef.addArrayTypedef(name = result, len = s):
+          typedef.add("NU8")
+      addTypeDecl(m, cfsTypes, result, typedef)
   of tyGenericInst, tyDistinct, tyOrdinal, tyTypeDesc, tyAlias, tySink, tyOwned,
      tyUserTypeClass, tyUserTypeClassInst, tyInferred:
     result = getTypeDescAux(m, skipModifier(t), check, kind)
@@ -1662,7 +1675,14 @@ proc genDisplay(m: BModule; t: PType, depth: int): Rope =
   result.add seqs[0]
   result.add "}"
 
-proc genVTable(seqs: seq[PSym]): string =
+proc genVTable(m: BModule; seqs: seq[PSym]): string =
+  # methods are not generated eagerly when they are dispatched through
+  # vtables, so the RTTI of a type is what keeps its methods alive
+  for i in seqs:
+    if useAliveDataFromDce in m.flags:
+      genProcPrototype(m, i)
+    else:
+      genProc(m, i)
   result = "{"
   for i in 0..<seqs.len:
     if i > 0: result.add ", "
@@ -1708,9 +1728,7 @@ proc genTypeInfoV2OldImpl(m: BModule; t, origType: PType, name: Rope; info: TLin
   let dispatchMethods = toSeq(getMethodsPerType(m.g.graph, t))
   if dispatchMethods.len > 0:
     let vTablePointerName = getTempName(m)
-    m.s[cfsVars].addf("static void* $1[$2] = $3;$n", [vTablePointerName, rope(dispatchMethods.len), genVTable(dispatchMethods)])
-    for i in dispatchMethods:
-      genProcPrototype(m, i)
+    m.s[cfsVars].addf("static void* $1[$2] = $3;$n", [vTablePointerName, rope(dispatchMethods.len), genVTable(m, dispatchMethods)])
     addf(typeEntry, "$1.vTable = $2;$n", [name, vTablePointerName])
 
   m.s[cfsTypeInit3].add typeEntry
@@ -1757,9 +1775,7 @@ proc genTypeInfoV2Impl(m: BModule; t, origType: PType, name: Rope; info: TLineIn
   let dispatchMethods = toSeq(getMethodsPerType(m.g.graph, t))
   if dispatchMethods.len > 0:
     addf(typeEntry, ", .flags = $1", [rope(flags)])
-    for i in dispatchMethods:
-      genProcPrototype(m, i)
-    addf(typeEntry, ", .vTable = $1};$n", [genVTable(dispatchMethods)])
+    addf(typeEntry, ", .vTable = $1};$n", [genVTable(m, dispatchMethods)])
     m.s[cfsVars].add typeEntry
   else:
     addf(typeEntry, ", .flags = $1};$n", [rope(flags)])
@@ -20,7 +20,7 @@ import
 
 from expanddefaults import caseObjDefaultBranch
 
-import pipelineutils
+import pipelineutils, compilerprofiler
 
 when defined(nimPreviewSlimSystem):
   import std/assertions
@@ -1196,9 +1196,12 @@ proc genProcAux*(m: BModule, prc: PSym) =
   var returnStmt: Rope = ""
   assert(prc.ast != nil)
 
-  var procBody = transformBody(m.g.graph, m.idgen, prc, {})
+  var procBody: PNode = nil
+  m.config.profile(ppTransf, prc.name.s):
+    procBody = transformBody(m.g.graph, m.idgen, prc, {})
   if sfInjectDestructors in prc.flags:
-    procBody = injectDestructorCalls(m.g.graph, m.idgen, prc, procBody)
+    m.config.profile(ppDestructors, prc.name.s):
+      procBody = injectDestructorCalls(m.g.graph, m.idgen, prc, procBody)
 
   let tmpInfo = prc.info
   discard freshLineInfo(p, prc.info)
@@ -1291,7 +1294,13 @@ proc genProcAux*(m: BModule, prc: PSym) =
     if optStackTrace in prc.options: generatedProc.add(deinitFrame(p))
     generatedProc.add(returnStmt)
     generatedProc.add("}\n")
-  m.s[cfsProcs].add(generatedProc)
+  if prc.typ.callConv == ccInline and m.config.cUnity > 0:
+    # inline procs are generated into every module that uses them, which
+    # would define them more than once in a translation unit of `--cUnity`
+    m.s[cfsProcs].addf("#ifndef NIM_PROC_$1$n#define NIM_PROC_$1$n$2#endif$n",
+                       [prc.loc.snippet, generatedProc])
+  else:
+    m.s[cfsProcs].add(generatedProc)
   if isReloadable(m, prc):
     m.s[cfsDynLibInit].addf("\t$1 = ($3) hcrRegisterProc($4, \"$1\", (void*)$2);$n",
          [prc.loc.snippet, prc.loc.snippet & "_actual", getProcTypeCast(m, prc), getModuleDllPath(m, prc)])
@@ -1472,12 +1481,14 @@ proc headerTop(): Rope =
 proc getCopyright(conf: ConfigRef; cfile: Cfile): Rope =
   result = headerTop()
   if optCompileOnly notin conf.globalOptions:
+    # without the `--pgo` options, so that the instrumented and the optimized
+    # build see the same C code
     result.add ("/* Compiled for: $1, $2, $3 */$N" &
         "/* Command for C compiler:$n   $4 */$N") %
         [rope(platform.OS[conf.target.targetOS].name),
         rope(platform.CPU[conf.target.targetCPU].name),
         rope(extccomp.CC[conf.cCompiler].name),
-        rope(getCompileCFileCmd(conf, cfile))]
+        rope(getCompileCFileCmd(conf, cfile, pgo = false))]
 
 proc getFileHeader(conf: ConfigRef; cfile: Cfile): Rope =
   result = getCopyright(conf, cfile)
@@ -2179,9 +2190,12 @@ proc genTopLevelStmt*(m: BModule; n: PNode) =
   m.initProc.options = initProcOptions(m)
   #softRnl = if optLineDir in m.config.options: noRnl else: rnl
   # XXX replicate this logic!
-  var transformedN = transformStmt(m.g.graph, m.idgen, m.module, n)
+  var transformedN: PNode = nil
+  m.config.profile(ppTransf, "top level"):
+    transformedN = transformStmt(m.g.graph, m.idgen, m.module, n)
   if sfInjectDestructors in m.module.flags:
-    transformedN = injectDestructorCalls(m.g.graph, m.idgen, m.module, transformedN)
+    m.config.profile(ppDestructors, "top level"):
+      transformedN = injectDestructorCalls(m.g.graph, m.idgen, m.module, transformedN)
 
   if m.hcrOn:
     addHcrInitGuards(m.initProc, transformedN, m.inHcrInitGuard)
@@ -2325,9 +2339,7 @@ proc finalCodegenActions*(graph: ModuleGraph; m: BModule; n: PNode) =
 
       if m.g.forwardedProcs.len == 0:
         incl m.flags, objHasKidsValid
-      if optMultiMethods in m.g.config.globalOptions or
-          m.g.config.selectedGC notin {gcArc, gcOrc, gcAtomicArc} or
-          vtables notin m.g.config.features:
+      if not m.g.config.usesVTables:
         generateIfMethodDispatchers(graph, m.idgen)
 
 
@@ -2354,9 +2366,11 @@ proc cgenWriteModules*(backend: RootRef, config: ConfigRef) =
   # we need to process the transitive closure because recursive module
   # deps are allowed (and the system module is processed in the wrong
   # order anyway)
-  genForwardedProcs(g)
+  config.profile(ppCodegen, "forwarded procs"):
+    genForwardedProcs(g)
 
-  for m in cgenModules(g):
-    m.writeModule(pending=true)
+  config.profile(ppWrite, "write C files"):
+    for m in cgenModules(g):
+      m.writeModule(pending=true)
   writeMapping(config, g.mapping)
   if g.generatedHeader != nil: writeHeader(g.generatedHeader)
@@ -27,7 +27,7 @@ bootSwitch(usedNoGC, defined(nogc), "--gc:none")
 import std/[setutils, os, strutils, parseutils, parseopt, sequtils, strtabs, enumutils]
 import
   msgs, options, nversion, condsyms, extccomp, platform,
-  wordrecg, nimblecmd, lineinfos, pathutils
+  wordrecg, nimblecmd, lineinfos, pathutils, compilerprofiler
 
 import std/pathnorm
 
@@ -944,6 +944,23 @@ proc processSwitch*(switch, arg: string, pass: TCmdLinePass, info: TLineInfo;
     var value: int = 0
     discard parseSaturatedNatural(arg, value)
     conf.numberOfProcessors = value
+  of "pgo":
+    expectArg(conf, switch, arg, pass, info)
+    let colon = arg.find(':')
+    let mode = if colon < 0: arg else: arg.substr(0, colon - 1)
+    case mode.normalize
+    of "off": conf.pgo = pgoNone
+    of "gen": conf.pgo = pgoGen
+    of "use": conf.pgo = pgoUse
+    else: localError(conf, info, "'gen', 'use' or 'off' expected, but '$1' found" % mode)
+    if colon >= 0:
+      conf.pgoDir = processPath(conf, arg.substr(colon + 1), info,
+                                notRelativeToProj=true)
+  of "cunity":
+    expectArg(conf, switch, arg, pass, info)
+    var value: int = 0
+    discard parseSaturatedNatural(arg, value)
+    conf.cUnity = value
   of "version", "v":
     expectNoArg(conf, switch, arg, pass, info)
     writeVersionInfo(conf, pass)
@@ -1127,6 +1144,11 @@ proc processSwitch*(switch, arg: string, pass: TCmdLinePass, info: TLineInfo;
     processOnOffSwitchG(conf, {optBenchmarkVM}, arg, pass, info)
   of "profilevm":
     processOnOffSwitchG(conf, {optProfileVM}, arg, pass, info)
+  of "profilecompiler":
+    expectArg(conf, switch, arg, pass, info)
+    if conf.profiler == nil:
+      conf.profiler = newCompilerProfiler(
+        AbsoluteFile processPath(conf, arg, info, notRelativeToProj=true).string)
   of "sinkinference":
     processOnOffSwitch(conf, {optSinkInference}, arg, pass, info)
   of "cursorinference":
@@ -0,0 +1,178 @@
+#
+#
+#           The Nim Compiler
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## This module implements `--profileCompiler:file`. The compiler's phases
+## are timed per module and per routine and written as a Chrome trace to
+## `file`, which can be opened with `chrome://tracing`, Perfetto or
+## speedscope. The trace also contains counters for generic instantiations,
+## macro and template expansions and allocated nodes, sampled after every
+## module. At the end a summary of the time spent per phase and per module
+## is printed. The totals per phase, the counters and the peak memory are
+## also stored in the `otherData` of the trace, for tools like
+## `koch benchcompiler`.
+
+import options, ast, pathutils, msgs, lineinfos
+
+import std/[monotimes, json, strutils, tables, algorithm]
+
+when defined(nimPreviewSlimSystem):
+  import std/[syncio, assertions]
+
+when defined(posix):
+  import std/posix
+
+const granularity = 100_000
+  ## spans shorter than this many nanoseconds are only added to the summary,
+  ## to keep the trace small
+
+proc now(p: CompilerProfiler): int64 {.inline.} =
+  getMonoTime().ticks - p.start
+
+proc newCompilerProfiler*(file: AbsoluteFile): CompilerProfiler =
+  result = CompilerProfiler(file: file, start: getMonoTime().ticks)
+
+proc enter*(p: CompilerProfiler; phase: ProfilePhase; name: string) =
+  let module = if phase == ppModule: name
+               elif p.stack.len == 0: ""
+               else: p.stack[^1].module
+  p.stack.add ProfileSpan(phase: phase, name: name, module: module,
+                          start: p.now)
+
+proc sample(p: CompilerProfiler; time: int64) =
+  p.counters[pcNodes] = nodesAllocated
+  p.samples.add (time, p.counters)
+
+proc leave*(p: CompilerProfiler) =
+  var span = p.stack.pop()
+  let time = p.now
+  span.dur = time - span.start
+  if p.stack.len > 0:
+    inc p.stack[^1].children, span.dur
+  p.selfTimes.mgetOrPut(span.module, default(array[ProfilePhase, int64]))[
+    span.phase] += span.dur - span.children
+  if span.dur >= granularity or span.phase == ppModule:
+    p.events.add span
+  if span.phase == ppModule:
+    p.sample(time)
+
+template profile*(conf: ConfigRef; phase: ProfilePhase; name: string;
+                  body: untyped) =
+  ## Runs `body` as a span of `phase`; `name` is only evaluated if the
+  ## profiler is enabled.
+  let prof = conf.profiler
+  if prof != nil: enter(prof, phase, name)
+  try:
+    body
+  finally:
+    if prof != nil: leave(prof)
+
+template count*(conf: ConfigRef; counter: ProfileCounter) =
+  if conf.profiler != nil: inc conf.profiler.counters[counter]
+
+proc startTime*(conf: ConfigRef): int64 =
+  ## The current time for `addSpan`, or 0 if the profiler is disabled.
+  result = if conf.profiler != nil: conf.profiler.now else: 0
+
+proc addSpan*(conf: ConfigRef; phase: ProfilePhase; name: string;
+              start: int64) =
+  ## Adds a span of an external process that was started at `start` and has
+  ## just finished. Processes that run in parallel get lanes of their own.
+  ## The span is not part of the summary, which covers the compiler's own
+  ## time.
+  let p = conf.profiler
+  if p == nil: return
+  let time = p.now
+  var lane = 0
+  while lane < p.laneEnds.len and p.laneEnds[lane] > start: inc lane
+  if lane == p.laneEnds.len: p.laneEnds.add time
+  else: p.laneEnds[lane] = time
+  p.events.add ProfileSpan(phase: phase, name: name, start: start,
+                           dur: time - start, lane: lane + 1)
+
+proc micros(ns: int64): string =
+  formatFloat(ns.float / 1000, ffDecimal, 1)
+
+proc peakMemory(): int =
+  ## The peak resident set size of the compiler in bytes, or the peak size of
+  ## its heap where that is not available.
+  result = when declared(system.getMaxMem): getMaxMem() else: getTotalMem()
+  when defined(posix):
+    var usage = default(Rusage)
+    if getrusage(RUSAGE_SELF, addr usage) == 0:
+      result = usage.ru_maxrss.int * (when defined(macosx): 1 else: 1024)
+
+proc phaseTotals(p: CompilerProfiler): array[ProfilePhase, int64] =
+  result = default(array[ProfilePhase, int64])
+  for times in p.selfTimes.values:
+    for phase in ProfilePhase: inc result[phase], times[phase]
+
+proc writeTrace(conf: ConfigRef; p: CompilerProfiler) =
+  var s = "{\"traceEvents\":[\n" &
+    """{"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"nim"}}"""
+  for lane in 1..p.laneEnds.len:
+    s.add ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" &
+      $lane & ",\"args\":{\"name\":\"external " & $lane & "\"}}"
+  for e in p.events:
+    s.add ",\n{\"name\":" & escapeJson(e.name) & ",\"cat\":\"" & $e.phase &
+      "\",\"ph\":\"X\",\"ts\":" & micros(e.start) & ",\"dur\":" &
+      micros(e.dur) & ",\"pid\":1,\"tid\":" & $e.lane
+    if e.phase != ppModule and e.lane == 0:
+      s.add ",\"args\":{\"module\":" & escapeJson(e.module) & "}"
+    s.add "}"
+  for (time, counters) in p.samples:
+    s.add ",\n{\"name\":\"counters\",\"ph\":\"C\",\"ts\":" & micros(time) &
+      ",\"pid\":1,\"args\":{"
+    for c in ProfileCounter:
+      if c != low(ProfileCounter): s.add ","
+      s.add escapeJson($c) & ":" & $counters[c]
+    s.add "}}"
+  s.add "\n],\n\"otherData\":{\"peak memory\":" & $peakMemory()
+  let total = phaseTotals(p)
+  for phase in ProfilePhase:
+    s.add "," & escapeJson($phase & " ms") & ":" &
+      formatFloat(total[phase].float / 1e6, ffDecimal, 3)
+  for c in ProfileCounter:
+    s.add "," & escapeJson($c) & ":" & $p.counters[c]
+  s.add "}}\n"
+  try:
+    writeFile(p.file.string, s)
+  except IOError:
+    rawMessage(conf, errCannotOpenFile, p.file.string)
+
+proc summary(p: CompilerProfiler): string =
+  proc ms(ns: int64): string = align(formatFloat(ns.float / 1e6, ffDecimal, 1), 10)
+
+  let total = phaseTotals(p)
+  var modules: seq[(int64, string)] = @[]
+  for module, times in p.selfTimes:
+    var sum = 0'i64
+    for phase in ProfilePhase: inc sum, times[phase]
+    modules.add (sum, module)
+  modules.sort(Descending)
+
+  result = "\nprofile: " & $p.file & "\n\n        ms  phase\n"
+  for phase in ProfilePhase:
+    if total[phase] > 0:
+      result.add ms(total[phase]) & "  " & $phase & "\n"
+  result.add "\n        ms  module (self time)\n"
+  for i in 0..<min(modules.len, 20):
+    result.add ms(modules[i][0]) & "  " &
+      (if modules[i][1].len == 0: "(backend)" else: modules[i][1]) & "\n"
+  result.add "\n"
+  for c in ProfileCounter:
+    result.add align($p.counters[c], 10) & "  " & $c & "\n"
+  result.add align(formatSize(peakMemory()), 10) & "  peak memory\n"
+
+proc writeProfile*(conf: ConfigRef): string =
+  ## Writes the trace and returns the summary.
+  let p = conf.profiler
+  while p.stack.len > 0: p.leave() # after a fatal error
+  p.sample(p.now)
+  writeTrace(conf, p)
+  result = summary(p)
@@ -12,7 +12,8 @@
 # from a lineinfos file, to provide generalized procedures to compile
 # nim files.
 
-import ropes, platform, condsyms, options, msgs, lineinfos, pathutils, modulepaths
+import ropes, platform, condsyms, options, msgs, lineinfos, pathutils, modulepaths,
+  compilerprofiler
 
 import std/[os, osproc, streams, sequtils, times, strtabs, json, jsonutils, sugar, parseutils]
 
@@ -458,6 +459,97 @@ proc getOptSize(conf: ConfigRef; c: TSystemCC): string =
   if result == "":
     result = CC[c].optSize    # use default settings from this file
 
+proc getPgoDir*(conf: ConfigRef): AbsoluteDir =
+  ## The directory of the profile for `--pgo`. It defaults to `<project>_pgo`
+  ## next to the project file rather than a place in the nimcache, so that
+  ## the profile survives a change of the nimcache.
+  if conf.pgoDir.isEmpty:
+    result = conf.projectPath / RelativeDir(splitFile(conf.projectName).name & "_pgo")
+  else:
+    result = conf.pgoDir
+
+proc getPgoOptions(conf: ConfigRef; link: bool): string =
+  ## The options of the C compiler (or of the linker if `link`) for `--pgo`.
+  let dir = quoteShell(getPgoDir(conf))
+  case conf.pgo
+  of pgoNone:
+    result = ""
+  of pgoGen:
+    case conf.cCompiler
+    of ccGcc, ccLLVM_Gcc, ccCLang: result = "-fprofile-generate=" & dir
+    of ccIcc: result = if link: "-prof-gen" else: "-prof-gen -prof-dir=" & dir
+    of ccIcl: result = if link: "" else: "/Qprof-gen /Qprof-dir:" & dir
+    else: result = ""
+  of pgoUse:
+    if link: return ""
+    case conf.cCompiler
+    of ccGcc, ccLLVM_Gcc:
+      result = "-fprofile-use=" & dir & " -fprofile-correction -Wno-missing-profile"
+    of ccCLang:
+      result = "-fprofile-use=" & quoteShell(getPgoDir(conf) / RelativeFile"default.profdata") &
+        " -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date"
+    of ccIcc: result = "-prof-use -prof-dir=" & dir
+    of ccIcl: result = "/Qprof-use /Qprof-dir:" & dir
+    else: result = ""
+
+proc preparePgo(conf: ConfigRef) =
+  ## Makes the profile of `--pgo:use` available under the names the C
+  ## compiler looks for.
+  if getPgoOptions(conf, link = false) == "":
+    rawMessage(conf, warnUser, "--pgo is not supported for the C compiler " &
+      CC[conf.cCompiler].name)
+    return
+  let dir = getPgoDir(conf)
+  if conf.pgo == pgoGen:
+    try:
+      createDir(dir.string)
+    except OSError:
+      rawMessage(conf, errCannotOpenFile, dir.string)
+    return
+  if not dirExists(dir.string):
+    rawMessage(conf, warnUser, "--pgo:use: there is no profile in " & dir.string)
+    return
+  case conf.cCompiler
+  of ccGcc, ccLLVM_Gcc:
+    # gcc names the profile of an object file after its full path, with the
+    # directory separators replaced by '#', so that it is lost as soon as the
+    # nimcache moves. The names of the object files stay the same though,
+    # so a profile recorded under another path is copied to the current one.
+    var profiles: seq[string] = @[]
+    for f in walkFiles(dir.string / "*.gcda"): profiles.add f
+    for it in conf.toCompile:
+      let name = it.obj.string.changeFileExt("")
+      let wanted = dir.string / name.multiReplace(("/", "#"), ("\\", "#")) & ".gcda"
+      if fileExists(wanted): continue
+      var found = ""
+      for f in profiles:
+        if f.extractFilename.endsWith("#" & name.extractFilename & ".gcda") and
+            (found == "" or fileNewer(f, found)):
+          found = f
+      if found != "":
+        try:
+          copyFile(found, wanted)
+        except OSError:
+          rawMessage(conf, errCannotOpenFile, wanted)
+  of ccCLang:
+    # the raw profiles that the instrumented program writes need to be merged
+    let profdata = dir / RelativeFile"default.profdata"
+    var raws = ""
+    var outdated = not fileExists(profdata)
+    for f in walkFiles(dir.string / "*.profraw"):
+      raws.add ' '
+      raws.add quoteShell(f)
+      if not outdated and fileNewer(f, profdata.string): outdated = true
+    if raws.len > 0 and outdated:
+      var exe = getConfigVar(conf, conf.cCompiler, ".profdata")
+      if exe.len == 0: exe = "llvm-profdata"
+      execExternalProgram(conf, quoteShell(exe) & " merge -output=" &
+        quoteShell(profdata) & raws, hintExecuting)
+    elif not fileExists(profdata):
+      rawMessage(conf, warnUser, "--pgo:use: there is no profile in " & dir.string)
+  else:
+    discard
+
 proc noAbsolutePaths(conf: ConfigRef): bool {.inline.} =
   # We used to check current OS != specified OS, but this makes no sense
   # really: Cross compilation from Linux to Linux for example is entirely
@@ -572,7 +664,8 @@ proc getLinkerExe(conf: ConfigRef; compiler: TSystemCC): string =
            else: getCompilerExe(conf, compiler, optMixedMode in conf.globalOptions or conf.backend == backendCpp)
 
 proc getCompileCFileCmd*(conf: ConfigRef; cfile: Cfile,
-                         isMainFile = false; produceOutput = false): string =
+                         isMainFile = false; produceOutput = false;
+                         pgo = true): string =
   let
     c = conf.cCompiler
     isCpp = useCpp(conf, cfile.cname)
@@ -598,6 +691,10 @@ proc getCompileCFileCmd*(conf: ConfigRef; cfile: Cfile,
     options.add ' '
     options.add cfile.customArgs
 
+  if pgo and conf.pgo != pgoNone:
+    options.add ' '
+    options.add getPgoOptions(conf, link = false)
+
   var compilePattern: string
   # compute include paths:
   var includeCmd = CC[c].includeCmd & quoteShell(conf.libpath)
@@ -732,7 +829,8 @@ proc getLinkCmd(conf: ConfigRef; output: AbsoluteFile,
     let mapfile = quoteShell(getNimcacheDir(conf) / RelativeFile(splitFile(output).name & ".map"))
 
     let linkOptions = getLinkOptions(conf) & " " &
-                      getConfigVar(conf, conf.cCompiler, ".options.linker")
+                      getConfigVar(conf, conf.cCompiler, ".options.linker") & " " &
+                      getPgoOptions(conf, link = true)
     var linkTmpl = getConfigVar(conf, conf.cCompiler, ".linkTmpl")
     if linkTmpl.len == 0:
       linkTmpl = CC[conf.cCompiler].linkTmpl
@@ -816,8 +914,15 @@ proc execLinkCmd(conf: ConfigRef; linkCmd: string) =
   tryExceptOSErrorMessage(conf, "invocation of external linker program failed."):
     execExternalProgram(conf, linkCmd, hintLinking)
 
-proc execCmdsInParallel(conf: ConfigRef; cmds: seq[string]; prettyCb: proc (idx: int)) =
+proc execCmdsInParallel(conf: ConfigRef; cmds: seq[string]; prettyCb: proc (idx: int);
+                        phase = ppCCompile; names: seq[string] = @[]) =
+  ## `names` are the names of the commands for `--profileCompiler`.
+  var starts = newSeq[int64](cmds.len)
+  let startCb = proc (idx: int) =
+    starts[idx] = startTime(conf)
+    prettyCb(idx)
   let runCb = proc (idx: int, p: Process) =
+    addSpan(conf, phase, if idx < names.len: names[idx] else: cmds[idx], starts[idx])
     let exitCode = p.peekExitCode
     if exitCode != 0:
       rawMessage(conf, errGenerated, "execution of an external compiler program '" &
@@ -826,15 +931,17 @@ proc execCmdsInParallel(conf: ConfigRef; cmds: seq[string]; prettyCb: proc (idx:
   var res = 0
   if conf.numberOfProcessors <= 1:
     for i in 0..high(cmds):
+      let start = startTime(conf)
       tryExceptOSErrorMessage(conf, "invocation of external compiler program failed."):
         res = execWithEcho(conf, cmds[i])
+      addSpan(conf, phase, if i < names.len: names[i] else: cmds[i], start)
       if res != 0:
         rawMessage(conf, errGenerated, "execution of an external program failed: '$1'" %
           cmds[i])
   else:
     tryExceptOSErrorMessage(conf, "invocation of external compiler program failed."):
       res = execProcesses(cmds, {poStdErrToStdOut, poUsePath, poParentStreams},
-                            conf.numberOfProcessors, prettyCb, afterRunEvent=runCb)
+                            conf.numberOfProcessors, startCb, afterRunEvent=runCb)
   if res != 0:
     if conf.numberOfProcessors <= 1:
       rawMessage(conf, errGenerated, "execution of an external program failed: '$1'" %
@@ -910,32 +1017,87 @@ proc preventLinkCmdMaxCmdLen(conf: ConfigRef, linkCmd: string) =
   else:
     execLinkCmd(conf, linkCmd)
 
+proc mergeUnityFiles(conf: ConfigRef) =
+  ## Implements `--cUnity:N`: the C files generated for the Nim modules are
+  ## replaced by N translation units that include them, so that `nimbase.h`
+  ## and the system headers are only parsed N times and the C compiler can
+  ## inline across modules. The files are split in their original order into
+  ## units of about the same size, which keeps the units stable between
+  ## builds. Files with C compiler options of their own are not merged.
+  if conf.cUnity <= 0 or conf.hcrOn or conf.toCompile.len == 0: return
+  let ext = conf.toCompile[^1].cname.splitFile.ext
+  let options = getCompileOptions(conf)
+  var merged: seq[(Cfile, BiggestInt)] = @[]
+  var rest: seq[Cfile] = @[]
+  var total: BiggestInt = 0
+  for it in conf.toCompile:
+    if CfileFlag.External notin it.flags and it.customArgs == "" and
+        it.cname.splitFile.ext == ext and
+        cFileSpecificOptions(conf, it.nimname, it.cname.changeFileExt("").string) == options:
+      let size = try: max(getFileSize(it.cname.string), 1) except OSError: 1
+      merged.add (it, size)
+      inc total, size
+    else:
+      rest.add it
+  if merged.len <= conf.cUnity: return
+
+  conf.toCompile = rest
+  var i = 0
+  var size: BiggestInt = 0
+  for u in 0..<conf.cUnity:
+    let limit = total * (u + 1) div conf.cUnity
+    let cname = completeCfilePath(conf, AbsoluteFile("@unity" & $(u + 1) & ext))
+    var unit = Cfile(nimname: "@unity" & $(u + 1), cname: cname,
+                     obj: toObjFile(conf, cname), flags: {})
+    var code = ""
+    var cached = optForceFullMake notin conf.globalOptions and fileExists(unit.obj)
+    # every unit gets at least one file:
+    while i < merged.len and merged.len - i > conf.cUnity - u - 1 and
+        (code.len == 0 or size + merged[i][1] div 2 <= limit):
+      let f = merged[i][0].cname
+      code.add "#include \"" & (if noAbsolutePaths(conf): f.extractFilename else: f.string) & "\"\n"
+      if cached and not fileNewer(unit.obj.string, f.string): cached = false
+      inc size, merged[i][1]
+      inc i
+    if not equalsFile(code, cname):
+      if not writeRope(code, cname):
+        rawMessage(conf, errCannotOpenFile, cname.string)
+      cached = false
+    if cached: unit.flags.incl CfileFlag.Cached
+    conf.toCompile.add unit
+
 proc callCCompiler*(conf: ConfigRef) =
   var
     linkCmd: string = ""
     extraCmds: seq[string]
+  mergeUnityFiles(conf)
   if conf.globalOptions * {optCompileOnly, optGenScript} == {optCompileOnly}:
     return # speed up that call if only compiling and no script shall be
            # generated
+  if conf.pgo != pgoNone: preparePgo(conf)
   #var c = cCompiler
   var script: Rope = ""
   var cmds: TStringSeq = default(TStringSeq)
   var prettyCmds: TStringSeq = default(TStringSeq)
+  var names: seq[string] = @[]
   let prettyCb = proc (idx: int) = writePrettyCmdsStderr(prettyCmds[idx])
 
   for idx, it in conf.toCompile:
     # call the C compiler for the .c file:
-    if CfileFlag.Cached in it.flags: continue
+    # (with `--pgo` the C code stays the same, but the options change)
+    if CfileFlag.Cached in it.flags and conf.pgo == pgoNone: continue
     let compileCmd = getCompileCFileCmd(conf, it, idx == conf.toCompile.len - 1, produceOutput=true)
     if optCompileOnly notin conf.globalOptions:
       cmds.add(compileCmd)
       prettyCmds.add displayProgressCC(conf, $it.cname, compileCmd)
+      names.add extractFilename($it.cname)
     if optGenScript in conf.globalOptions:
       script.add(compileCmd)
       script.add("\n")
 
   if optCompileOnly notin conf.globalOptions:
-    execCmdsInParallel(conf, cmds, prettyCb)
+    conf.profile(ppCCompile, "C compiler"):
+      execCmdsInParallel(conf, cmds, prettyCb, ppCCompile, names)
   if optNoLinking notin conf.globalOptions:
     # call the linker:
     var objfiles = ""
@@ -968,7 +1130,8 @@ proc callCCompiler*(conf: ConfigRef) =
       # execute link commands in parallel - output will be a bit different
       # if it fails than that from execLinkCmd() but that doesn't matter
       prettyCmds = map(prettyCmds, proc (curr: string): string = return curr.replace("CC", "Link"))
-      execCmdsInParallel(conf, cmds, prettyCb)
+      conf.profile(ppLink, "link"):
+        execCmdsInParallel(conf, cmds, prettyCb, ppLink)
       # only if not cached - copy the resulting main file from the nimcache folder to its originally intended destination
       if CfileFlag.Cached notin conf.toCompile[mainFileIdx].flags:
         let mainObjFile = getObjFilePath(conf, conf.toCompile[mainFileIdx])
@@ -986,7 +1149,8 @@ proc callCCompiler*(conf: ConfigRef) =
       linkCmd = getLinkCmd(conf, mainOutput, objfiles, removeStaticFile = true)
       extraCmds = getExtraCmds(conf, mainOutput)
       if optCompileOnly notin conf.globalOptions:
-        preventLinkCmdMaxCmdLen(conf, linkCmd)
+        conf.profile(ppLink, "link"):
+          preventLinkCmdMaxCmdLen(conf, linkCmd)
         for cmd in extraCmds:
           execExternalProgram(conf, cmd, hintExecuting)
   else:
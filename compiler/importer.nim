@@ -156,6 +156,7 @@ proc importSymbol(c: PContext, n: PNode, fromMod: PSym; importSet: var IntSet) =
     suggestSym(c.graph, n.info, s, c.graph.usageSym, false)
 
 proc addImport(c: PContext; im: sink ImportedModule) =
+  inc c.lookupGeneration
   for i in 0..high(c.imports):
     if c.imports[i].m == im.m:
       # we have already imported the module: Check which import
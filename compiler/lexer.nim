@@ -865,11 +865,10 @@ proc getSymbol(L: var Lexer, tok: var Token) =
   tokenBegin(tok, pos)
   var suspicious = false
   while true:
+    # most identifiers consist of lower case letters and digits only:
+    hashLowerAlnum(L, pos, h)
     var c = L.buf[pos]
     case c
-    of 'a'..'z', '0'..'9':
-      h = h !& ord(c)
-      inc(pos)
     of 'A'..'Z':
       c = chr(ord(c) + (ord('a') - ord('A'))) # toLower()
       h = h !& ord(c)
@@ -982,6 +981,14 @@ proc getPrecedence*(tok: Token): int =
   of tkOr, tkXor, tkPtr, tkRef: result = 3
   else: return -10
 
+proc addChars(s: var string, L: Lexer, first, last: int) {.inline.} =
+  # appends `L.buf[first ..< last]`
+  let n = last - first
+  if n > 0:
+    let start = s.len
+    s.setLen(start + n)
+    copyMem(addr s[start], addr L.buf[first], n)
+
 proc skipMultiLineComment(L: var Lexer; tok: var Token; start: int;
                           isDoc: bool) =
   var pos = start
@@ -1042,8 +1049,9 @@ proc skipMultiLineComment(L: var Lexer; tok: var Token; start: int;
       lexMessagePos(L, errGenerated, pos, "end of multiline comment expected")
       break
     else:
-      if isDoc or defined(nimpretty): tok.literal.add L.buf[pos]
-      inc(pos)
+      let last = findCommentEnd(L, pos)
+      if isDoc or defined(nimpretty): addChars(tok.literal, L, pos, last)
+      pos = last
   L.bufpos = pos
   when defined(nimpretty):
     tok.commentOffsetB = L.offsetBase + pos - 1
@@ -1073,15 +1081,13 @@ proc scanComment(L: var Lexer, tok: var Token) =
         toStrip = 0
       else:  # found first non-whitespace character
         stripInit = true
-    while L.buf[pos] notin {CR, LF, nimlexbase.EndOfFile}:
-      tok.literal.add(L.buf[pos])
-      inc(pos)
+    let last = findLineEnd(L, pos)
+    addChars(tok.literal, L, pos, last)
+    pos = last
     tokenEndIgnore(tok, pos)
     pos = handleCRLF(L, pos)
-    var indent = 0
-    while L.buf[pos] == ' ':
-      inc(pos)
-      inc(indent)
+    let indent = skipSpaces(L, pos) - pos
+    inc(pos, indent)
 
     if L.buf[pos] == '#' and L.buf[pos+1] == '#':
       tok.literal.add "\n"
@@ -1113,7 +1119,7 @@ proc skip(L: var Lexer, tok: var Token) =
   while true:
     case L.buf[pos]
     of ' ':
-      inc(pos)
+      pos = skipSpaces(L, pos)
       tok.spacing.incl(tsLeading)
     of '\t':
       lexMessagePos(L, errGenerated, pos, "tabs are not allowed, use spaces instead")
@@ -1124,8 +1130,9 @@ proc skip(L: var Lexer, tok: var Token) =
       var indent = 0
       while true:
         if L.buf[pos] == ' ':
-          inc(pos)
-          inc(indent)
+          let next = skipSpaces(L, pos)
+          inc(indent, next - pos)
+          pos = next
         elif L.buf[pos] == '#' and L.buf[pos+1] == '[':
           when defined(nimpretty):
             hasComment = true
@@ -1156,9 +1163,9 @@ proc skip(L: var Lexer, tok: var Token) =
         pos = L.bufpos
       else:
         tokenBegin(tok, pos)
-        while L.buf[pos] notin {CR, LF, nimlexbase.EndOfFile}:
-          when defined(nimpretty): tok.literal.add L.buf[pos]
-          inc(pos)
+        let last = findLineEnd(L, pos)
+        when defined(nimpretty): addChars(tok.literal, L, pos, last)
+        pos = last
         tokenEndIgnore(tok, pos+1)
         when defined(nimpretty):
           tok.commentOffsetB = L.offsetBase + pos + 1
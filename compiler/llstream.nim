@@ -12,6 +12,8 @@
 import
   pathutils
 
+import std/memfiles
+
 when defined(nimPreviewSlimSystem):
   import std/syncio
 
@@ -29,11 +31,13 @@ type
     llsString,                # stream encapsulates a string
     llsFile,                  # stream encapsulates a file
     llsStdIn                  # stream encapsulates stdin
+    llsMemFile                # stream encapsulates a file mapped into memory
   TLLStream* = object of RootObj
     kind*: TLLStreamKind # accessible for low-level access (lexbase uses this)
     f*: File
     s*: string
-    rd*, wr*: int             # for string streams
+    mem*: MemFile             # for mapped files; nimlexbase lexes it in place
+    rd*, wr*: int             # for string streams and mapped files
     lineOffset*: int          # for fake stdin line numbers
     repl*: TLLRepl            # gives stdin control to clients
     onPrompt*: OnPrompt
@@ -53,6 +57,28 @@ proc llStreamOpen*(filename: AbsoluteFile, mode: FileMode): PLLStream =
 proc llStreamOpen*(): PLLStream =
   PLLStream(kind: llsNone)
 
+proc llStreamOpenSource*(filename: AbsoluteFile): PLLStream =
+  ## Opens a source file for reading. The file is mapped into memory if the
+  ## mapping is followed by at least 8 zero bytes: POSIX fills the rest of
+  ## the last page with zeros, which ends the data for nimlexbase, so that
+  ## it can lex the mapping without copying. Otherwise, or if the file
+  ## cannot be mapped, it is read like with `llStreamOpen`. The mapping is
+  ## shared with the file: truncating the file while it is being compiled
+  ## makes the compiler crash with SIGBUS.
+  const minPageSize = 4096
+  when defined(posix):
+    var mem: MemFile
+    try:
+      mem = memfiles.open(filename.string)
+    except OSError, IOError:
+      mem = default(MemFile)
+    # the size of the mapping, not of the file, which can have grown since
+    if mem.mem != nil:
+      if mem.size mod minPageSize in 1..minPageSize-8:
+        return PLLStream(kind: llsMemFile, mem: mem)
+      close(mem)
+  result = llStreamOpen(filename, fmRead)
+
 proc llReadFromStdin(s: PLLStream, buf: pointer, bufLen: int): int
 proc llStreamOpenStdIn*(r: TLLRepl = llReadFromStdin, onPrompt: OnPrompt = nil): PLLStream =
   PLLStream(kind: llsStdIn, s: "", lineOffset: -1, repl: r, onPrompt: onPrompt)
@@ -63,6 +89,10 @@ proc llStreamClose*(s: PLLStream) =
     discard
   of llsFile:
     close(s.f)
+  of llsMemFile:
+    if s.mem.mem != nil:
+      close(s.mem)
+      s.mem.mem = nil
 
 when not declared(readLineFromStdin):
   # fallback implementation:
@@ -134,6 +164,11 @@ proc llStreamRead*(s: PLLStream, buf: pointer, bufLen: int): int =
   of llsStdIn:
     if s.onPrompt!=nil: s.onPrompt()
     result = s.repl(s, buf, bufLen)
+  of llsMemFile:
+    result = min(bufLen, s.mem.size - s.rd)
+    if result > 0:
+      copyMem(buf, cast[pointer](cast[int](s.mem.mem) + s.rd), result)
+      inc(s.rd, result)
 
 proc llStreamReadLine*(s: PLLStream, line: var string): bool =
   setLen(line, 0)
@@ -158,10 +193,25 @@ proc llStreamReadLine*(s: PLLStream, line: var string): bool =
     result = readLine(s.f, line)
   of llsStdIn:
     result = readLine(stdin, line)
+  of llsMemFile:
+    let data = cast[ptr UncheckedArray[char]](s.mem.mem)
+    while s.rd < s.mem.size:
+      case data[s.rd]
+      of '\r':
+        inc(s.rd)
+        if s.rd < s.mem.size and data[s.rd] == '\n': inc(s.rd)
+        break
+      of '\n':
+        inc(s.rd)
+        break
+      else:
+        line.add(data[s.rd])
+        inc(s.rd)
+    result = line.len > 0 or s.rd < s.mem.size
 
 proc llStreamWrite*(s: PLLStream, data: string) =
   case s.kind
-  of llsNone, llsStdIn:
+  of llsNone, llsStdIn, llsMemFile:
     discard
   of llsString:
     s.s.add(data)
@@ -176,7 +226,7 @@ proc llStreamWriteln*(s: PLLStream, data: string) =
 proc llStreamWrite*(s: PLLStream, data: char) =
   var c: char
   case s.kind
-  of llsNone, llsStdIn:
+  of llsNone, llsStdIn, llsMemFile:
     discard
   of llsString:
     s.s.add(data)
@@ -187,7 +237,7 @@ proc llStreamWrite*(s: PLLStream, data: char) =
 
 proc llStreamWrite*(s: PLLStream, buf: pointer, buflen: int) =
   case s.kind
-  of llsNone, llsStdIn:
+  of llsNone, llsStdIn, llsMemFile:
     discard
   of llsString:
     if buflen > 0:
@@ -207,6 +257,11 @@ proc llStreamReadAll*(s: PLLStream): string =
     if s.rd == 0: result = s.s
     else: result = substr(s.s, s.rd)
     s.rd = s.s.len
+  of llsMemFile:
+    result = newString(s.mem.size - s.rd)
+    if result.len > 0:
+      copyMem(addr(result[0]), cast[pointer](cast[int](s.mem.mem) + s.rd), result.len)
+    s.rd = s.mem.size
   of llsFile:
     result = newString(bufSize)
     var bytes = readBuffer(s.f, addr(result[0]), bufSize)
@@ -20,7 +20,7 @@ import
   cgen, nversion,
   platform, nimconf, depends,
   modules,
-  modulegraphs, lineinfos, pathutils, vmprofiler
+  modulegraphs, lineinfos, pathutils, vmprofiler, compilerprofiler
 
 
 when defined(nimPreviewSlimSystem):
@@ -151,7 +151,8 @@ proc commandCompileToC(graph: ModuleGraph) =
     # for now we do not support writing out a .json file with the build instructions when HCR is on
     if not conf.hcrOn:
       extccomp.writeJsonBuildInstructions(conf, graph.cachedFiles)
-    if optGenScript in graph.config.globalOptions:
+    if optGenScript in graph.config.globalOptions or
+        isDefined(conf, "nimWriteDepsFile"): # for testament's `--cache`
       writeDepsFile(graph)
     if optGenCDeps in graph.config.globalOptions:
       writeCMakeDepsFile(conf)
@@ -430,6 +431,8 @@ proc mainCommand*(graph: ModuleGraph) =
     if optProfileVM in conf.globalOptions:
       echo conf.dump(conf.vmProfileData)
     genSuccessX(conf)
+  if conf.profiler != nil:
+    echo conf.writeProfile()
 
   when PrintRopeCacheStats:
     echo "rope cache stats: "
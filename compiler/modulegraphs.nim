@@ -55,6 +55,13 @@ type
     concreteTypes*: seq[FullId]
     inst*: PInstantiation
 
+  InstIndex* = object
+    ## Index over the instantiations of one generic in `typeInstCache` or
+    ## `procInstCache`, by a hash of their generic arguments.
+    byKey: Table[Hash, seq[int]]
+    pending: seq[int] # entries whose key cannot be computed yet
+    indexed: int      # the entries before this one are in `byKey` or `pending`
+
   PipelinePass* = enum
     NonePass
     SemPass
@@ -74,6 +81,8 @@ type
 
     typeInstCache*: Table[ItemId, seq[LazyType]] # A symbol's ItemId.
     procInstCache*: Table[ItemId, seq[LazyInstantiation]] # A symbol's ItemId.
+    typeInstIndex*: Table[ItemId, InstIndex] # A symbol's ItemId.
+    procInstIndex*: Table[ItemId, InstIndex] # A symbol's ItemId.
     attachedOps*: array[TTypeAttachedOp, Table[ItemId, LazySym]] # Type ID, destructors, etc.
     methodsPerGenericType*: Table[ItemId, seq[(int, LazySym)]] # Type ID, attached methods
     memberProcsPerType*: Table[ItemId, seq[PSym]] # Type ID, attached member procs (only c++, virtual,member and ctor so far).
@@ -153,6 +162,8 @@ proc resetForBackend*(g: ModuleGraph) =
   g.compilerprocs = initStrTable()
   g.typeInstCache.clear()
   g.procInstCache.clear()
+  g.typeInstIndex.clear()
+  g.procInstIndex.clear()
   for a in mitems(g.attachedOps):
     a.clear()
   g.methodsPerGenericType.clear()
@@ -336,17 +347,73 @@ proc resolveAttachedOp*(g: ModuleGraph; t: var LazySym): PSym =
     t.sym = result
   assert result != nil
 
-iterator typeInstCacheItems*(g: ModuleGraph; s: PSym): PType =
+const
+  unknownInstKey* = low(Hash) ## The key of an instantiation that is not
+                              ## complete yet.
+
+proc addSorted(s: var seq[int]; x: int) =
+  var i = s.len
+  s.add x
+  while i > 0 and s[i-1] > x:
+    s[i] = s[i-1]
+    dec i
+  s[i] = x
+
+template indexedItems(g, entries, index, key, resolve, keyOf: untyped) =
+  # Yields the entries whose key is `key` or not known yet, in the order in
+  # which they were added, like a linear scan that skips the entries that
+  # cannot match.
+  while index.indexed < entries.len:
+    let i = index.indexed
+    let k = keyOf(resolve(g, entries[i]))
+    if k == unknownInstKey: index.pending.add i
+    else: index.byKey.mgetOrPut(k, @[]).add i
+    inc index.indexed
+  var j = 0
+  while j < index.pending.len:
+    let i = index.pending[j]
+    let k = keyOf(resolve(g, entries[i]))
+    if k != unknownInstKey:
+      index.byKey.mgetOrPut(k, @[]).addSorted i
+      index.pending.delete j
+    else:
+      inc j
+  if key == unknownInstKey:
+    for i in 0..<entries.len:
+      yield resolve(g, entries[i])
+  else:
+    # the positions can be yielded from copies only, the caller may add entries
+    let hits = index.byKey.getOrDefault(key)
+    let pending = index.pending
+    var a = 0
+    var b = 0
+    while a < hits.len or b < pending.len:
+      if b >= pending.len or (a < hits.len and hits[a] < pending[b]):
+        yield resolve(g, entries[hits[a]])
+        inc a
+      else:
+        yield resolve(g, entries[pending[b]])
+        inc b
+
+iterator typeInstCacheItems*(g: ModuleGraph; s: PSym; key: Hash;
+                             keyOf: proc (t: PType): Hash {.nimcall.}): PType =
+  ## Yields the cached instantiations of the generic type `s` that can be
+  ## equal to an instantiation with the key `key`. `keyOf` computes the key
+  ## of an instantiation, or `unknownInstKey`; equal instantiations must
+  ## have equal keys.
   if g.typeInstCache.contains(s.itemId):
     let x = addr(g.typeInstCache[s.itemId])
-    for t in mitems(x[]):
-      yield resolveType(g, t)
+    let index = addr(g.typeInstIndex.mgetOrPut(s.itemId, InstIndex()))
+    indexedItems(g, x[], index[], key, resolveType, keyOf)
 
-iterator procInstCacheItems*(g: ModuleGraph; s: PSym): PInstantiation =
+iterator procInstCacheItems*(g: ModuleGraph; s: PSym; key: Hash;
+                             keyOf: proc (inst: PInstantiation): Hash {.nimcall.}): PInstantiation =
+  ## Yields the cached instantiations of the generic routine `s` that can be
+  ## equal to an instantiation with the key `key`, like `typeInstCacheItems`.
   if g.procInstCache.contains(s.itemId):
     let x = addr(g.procInstCache[s.itemId])
-    for t in mitems(x[]):
-      yield resolveInst(g, t)
+    let index = addr(g.procInstIndex.mgetOrPut(s.itemId, InstIndex()))
+    indexedItems(g, x[], index[], key, resolveInst, keyOf)
 
 
 proc getAttachedOp*(g: ModuleGraph; t: PType; op: TTypeAttachedOp): PSym =
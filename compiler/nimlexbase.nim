@@ -14,7 +14,7 @@
 
 import llstream
 
-import std/strutils
+import std/[strutils, bitops, hashes]
 
 when defined(nimPreviewSlimSystem):
   import std/assertions
@@ -39,6 +39,8 @@ const
                               #   ^pos = 0     ^ sentinel = 12
                               #
   NewLines* = {CR, LF}
+  WordPadding = 8             # the buffer can be read 8 characters at a time
+                              # up to its sentinel, see `readWord`
 
 type
   TBaseLexer* = object of RootObj
@@ -107,7 +109,7 @@ proc fillBuffer(L: var TBaseLexer) =
         # double the buffer's size and try again:
         oldBufLen = L.bufLen
         L.bufLen = L.bufLen * 2
-        L.bufStorage.setLen(L.bufLen)
+        L.bufStorage.setLen(L.bufLen + WordPadding)
         L.buf = L.bufStorage.cstring
         assert(L.bufLen - oldBufLen == oldBufLen)
         charsRead = llStreamRead(L.stream, addr(L.buf[oldBufLen]),
@@ -150,14 +152,21 @@ proc openBaseLexer(L: var TBaseLexer, inputstream: PLLStream, bufLen = 8192) =
   assert(bufLen > 0)
   L.bufpos = 0
   L.offsetBase = 0
-  L.bufStorage = newString(bufLen)
-  L.buf = L.bufStorage.cstring
-  L.bufLen = bufLen
-  L.sentinel = bufLen - 1
   L.lineStart = 0
   L.lineNumber = 1            # lines start at 1
   L.stream = inputstream
-  fillBuffer(L)
+  if inputstream.kind == llsMemFile:
+    # lex the mapping in place; it is followed by zeros, see
+    # `llStreamOpenSource`, so it is never refilled:
+    L.buf = cast[cstring](inputstream.mem.mem)
+    L.bufLen = inputstream.mem.size + 1
+    L.sentinel = inputstream.mem.size
+  else:
+    L.bufStorage = newString(bufLen + WordPadding)
+    L.buf = L.bufStorage.cstring
+    L.bufLen = bufLen
+    L.sentinel = bufLen - 1
+    fillBuffer(L)
   skipUTF8BOM(L)
 
 proc getColNumber(L: TBaseLexer, pos: int): int =
@@ -172,3 +181,86 @@ proc getCurrentLine(L: TBaseLexer, marker: bool = true): string =
   result.add "\n"
   if marker:
     result.add spaces(getColNumber(L, L.bufpos)) & '^' & "\n"
+
+# Scanning 8 characters at a time: the lexer skips runs of spaces, comment
+# text and identifier characters with the following procs, which test all
+# bytes of a word at once (SWAR). A scan stops at the first character that
+# does not belong to the run; as the sentinel is a line ending or
+# `EndOfFile`, which belongs to no run, the characters after it are read but
+# never used.
+
+const
+  lowBits = 0x0101010101010101'u64
+  highBits = 0x8080808080808080'u64
+
+proc readWord(L: TBaseLexer, pos: int): uint64 {.inline.} =
+  # the 8 characters at `pos`, `L.buf[pos]` in the lowest byte
+  result = 0
+  copyMem(addr result, addr L.buf[pos], sizeof(result))
+  when cpuEndian == bigEndian:
+    var le = 0'u64
+    for i in 0..7: le = le or (((result shr (8*i)) and 0xFF) shl (8*(7-i)))
+    result = le
+
+template repeated(c: char): uint64 = lowBits * uint64(ord(c))
+
+proc zeroBytes(x: uint64): uint64 {.inline.} =
+  # the high bit of a byte is set if the byte of `x` is 0; bits above the
+  # lowest set one may be wrong
+  (x - lowBits) and not x and highBits
+
+proc nonZeroBytes(x: uint64): uint64 {.inline.} =
+  # the high bit of a byte is set if the byte of `x` is not 0
+  (((x and not highBits) + not highBits) or x) and highBits
+
+proc inRange(x: uint64, a, b: char): uint64 {.inline.} =
+  # the high bit of a byte is set if the byte of `x` is in `a..b`
+  let y = x or highBits
+  ((y - repeated(a)) and not (y - repeated(succ(b)))) and not x and highBits
+
+proc firstByte(mask: uint64): int {.inline.} =
+  countTrailingZeroBits(mask) shr 3
+
+proc skipSpaces*(L: TBaseLexer, pos: int): int =
+  ## Returns the position of the first character at or after `pos` that is
+  ## not a space.
+  result = pos
+  while true:
+    let m = nonZeroBytes(readWord(L, result) xor repeated(' '))
+    if m != 0: return result + firstByte(m)
+    inc result, 8
+
+proc findLineEnd*(L: TBaseLexer, pos: int): int =
+  ## Returns the position of the first CR, LF or `EndOfFile` at or after
+  ## `pos`.
+  result = pos
+  while true:
+    let x = readWord(L, result)
+    let m = zeroBytes(x xor repeated(CR)) or zeroBytes(x xor repeated(LF)) or
+            zeroBytes(x)
+    if m != 0: return result + firstByte(m)
+    inc result, 8
+
+proc findCommentEnd*(L: TBaseLexer, pos: int): int =
+  ## Returns the position of the first character at or after `pos` that can
+  ## end or nest a multi line comment: '#', ']', CR, LF or `EndOfFile`.
+  result = pos
+  while true:
+    let x = readWord(L, result)
+    let m = zeroBytes(x xor repeated('#')) or zeroBytes(x xor repeated(']')) or
+            zeroBytes(x xor repeated(CR)) or zeroBytes(x xor repeated(LF)) or
+            zeroBytes(x)
+    if m != 0: return result + firstByte(m)
+    inc result, 8
+
+proc hashLowerAlnum*(L: TBaseLexer, pos: var int, h: var Hash) =
+  ## Advances `pos` over the run of characters in `'a'..'z'` and `'0'..'9'`
+  ## that starts at it and combines each of them into `h` with `!&`.
+  while true:
+    let x = readWord(L, pos)
+    let m = not (inRange(x, 'a', 'z') or inRange(x, '0', '9')) and highBits
+    let n = if m == 0: 8 else: firstByte(m)
+    for i in 0..<n:
+      h = h !& int((x shr (8*i)) and 0xFF)
+    inc pos, n
+    if n < 8: break
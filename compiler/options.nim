@@ -255,6 +255,11 @@ type
     ccNone, ccGcc, ccNintendoSwitch, ccLLVM_Gcc, ccCLang, ccBcc, ccVcc,
     ccTcc, ccEnv, ccIcl, ccIcc, ccClangCl, ccHipcc, ccNvcc
 
+  PgoMode* = enum  ## profile guided optimization of the generated C code
+    pgoNone,         ## no PGO
+    pgoGen,          ## `--pgo:gen`: instrument the program to write a profile
+    pgoUse           ## `--pgo:use`: optimize with the written profile
+
   ExceptionSystem* = enum
     excNone,   # no exception system selected yet
     excSetjmp, # setjmp based exception handling
@@ -319,6 +324,45 @@ type
   ProfileData* = ref object
     data*: TableRef[TLineInfo, ProfileInfo]
 
+  ProfilePhase* = enum ## what `--profileCompiler` attributes time to
+    ppModule = "module"           # time of a module not spent in other phases
+    ppParse = "parse"
+    ppSem = "sem"
+    ppInstantiate = "instantiate" # semantic checking of generic instances
+    ppMacro = "macro"
+    ppTransf = "transf"
+    ppDestructors = "injectdestructors"
+    ppCodegen = "codegen"
+    ppWrite = "write"             # writing the generated files
+    ppCCompile = "cc"
+    ppLink = "link"
+
+  ProfileCounter* = enum
+    pcInstantiations = "generic instantiations"
+    pcMacroExpansions = "macro expansions"
+    pcTemplateExpansions = "template expansions"
+    pcNodes = "nodes allocated"
+    pcVmInstructions = "VM instructions"
+
+  ProfileSpan* = object
+    phase*: ProfilePhase
+    name*: string
+    module*: string       # the module that was compiled when the span began
+    start*, dur*: int64   # in nanoseconds since the start of the compiler
+    children*: int64      # the time spent in nested spans
+    lane*: int            # the thread lane of the trace, 0 for the compiler
+
+  CompilerProfiler* = ref object
+    ## The data collected for `--profileCompiler`, see `compilerprofiler`.
+    file*: AbsoluteFile
+    start*: int64
+    stack*: seq[ProfileSpan]
+    events*: seq[ProfileSpan] # finished spans that are written to the trace
+    laneEnds*: seq[int64]     # the end of the last span of every extra lane
+    counters*: array[ProfileCounter, int]
+    samples*: seq[tuple[time: int64, counters: array[ProfileCounter, int]]]
+    selfTimes*: Table[string, array[ProfilePhase, int64]] # per module
+
   StdOrrKind* = enum
     stdOrrStdout
     stdOrrStderr
@@ -357,6 +401,11 @@ type
     hintProcessingDots*: bool # true for dots, false for filenames
     verbosity*: int            # how verbose the compiler is
     numberOfProcessors*: int   # number of processors
+    cUnity*: int               # number of C translation units for `--cUnity`;
+                               # 0 compiles every module on its own
+    pgo*: PgoMode
+    pgoDir*: AbsoluteDir       # where the profile is written and read;
+                               # see `extccomp.pgoDir` for the default
     lastCmdTime*: float        # when caas is enabled, we measure each command
     symbolFiles*: SymbolFilesOption
     spellSuggestMax*: int # max number of spelling suggestions for typos
@@ -437,6 +486,7 @@ type
     cppCustomNamespace*: string
     nimMainPrefix*: string
     vmProfileData*: ProfileData
+    profiler*: CompilerProfiler # nil unless `--profileCompiler` is given
 
     expandProgress*: bool
     expandLevels*: int
@@ -681,6 +731,10 @@ template quitOrRaise*(conf: ConfigRef, msg = "") =
 
 proc importantComments*(conf: ConfigRef): bool {.inline.} = conf.cmd in cmdDocLike + {cmdIdeTools}
 proc usesWriteBarrier*(conf: ConfigRef): bool {.inline.} = conf.selectedGC >= gcRefc
+proc usesVTables*(conf: ConfigRef): bool {.inline.} =
+  ## methods are dispatched through vtables stored in the RTTI of their type
+  optMultiMethods notin conf.globalOptions and
+    conf.selectedGC in {gcArc, gcOrc, gcAtomicArc} and vtables in conf.features
 
 template compilationCachePresent*(conf: ConfigRef): untyped =
   false
@@ -108,7 +108,7 @@ proc processModule*(graph: ModuleGraph; module: PSym; idgen: IdGenerator;
   openPasses(graph, a, module, idgen)
   if stream == nil:
     let filename = toFullPathConsiderDirty(graph.config, fileIdx)
-    s = llStreamOpen(filename, fmRead)
+    s = llStreamOpenSource(filename)
     if s == nil:
       rawMessage(graph.config, errCannotOpenFile, filename.string)
       return false
@@ -3,7 +3,7 @@ import sem, cgen, modulegraphs, ast, llstream, parser, msgs,
        packages, syntaxes, depends, vm, pragmas, idents, lookups, wordrecg,
        liftdestructors
 
-import pipelineutils
+import pipelineutils, compilerprofiler
 
 import ../dist/checksums/src/checksums/sha1
 
@@ -136,7 +136,7 @@ proc processPipelineModule*(graph: ModuleGraph; module: PSym; idgen: IdGenerator
 
   if stream == nil:
     let filename = toFullPathConsiderDirty(graph.config, fileIdx)
-    s = llStreamOpen(filename, fmRead)
+    s = llStreamOpenSource(filename)
     if s == nil:
       rawMessage(graph.config, errCannotOpenFile, filename.string)
       return false
@@ -159,32 +159,41 @@ proc processPipelineModule*(graph: ModuleGraph; module: PSym; idgen: IdGenerator
     checkFirstLineIndentation(p)
     block processCode:
       if graph.stopCompile(): break processCode
-      var n = parseTopLevelStmt(p)
-      if n.kind == nkEmpty: break processCode
-      # read everything, no streaming possible
-      var sl = newNodeI(nkStmtList, n.info)
-      sl.add n
-      while true:
+      var sl: PNode = nil
+      graph.config.profile(ppParse, "parse"):
         var n = parseTopLevelStmt(p)
-        if n.kind == nkEmpty: break
-        sl.add n
+        if n.kind != nkEmpty:
+          # read everything, no streaming possible
+          sl = newNodeI(nkStmtList, n.info)
+          sl.add n
+          while true:
+            var n = parseTopLevelStmt(p)
+            if n.kind == nkEmpty: break
+            sl.add n
+      if sl == nil: break processCode
 
       prePass(ctx, sl)
       if sfReorder in module.flags or codeReordering in graph.config.features:
         sl = reorder(graph, sl, module)
       if graph.pipelinePass != EvalPass:
         message(graph.config, sl.info, hintProcessingStmt, $idgen[])
-      var semNode = semWithPContext(ctx, sl)
-      discard processPipeline(graph, semNode, bModule)
+      var semNode: PNode = nil
+      graph.config.profile(ppSem, "sem"):
+        semNode = semWithPContext(ctx, sl)
+      graph.config.profile(ppCodegen, "codegen"):
+        discard processPipeline(graph, semNode, bModule)
 
     closeParser(p)
     if s.kind != llsStdIn: break
-  let finalNode = closePContext(graph, ctx, nil)
+  var finalNode: PNode = nil
+  graph.config.profile(ppSem, "close"):
+    finalNode = closePContext(graph, ctx, nil)
   case graph.pipelinePass
   of CgenPass:
     if bModule != nil:
       let m = BModule(bModule)
-      finalCodegenActions(graph, m, finalNode)
+      graph.config.profile(ppCodegen, "final codegen"):
+        finalCodegenActions(graph, m, finalNode)
       if graph.dispatchers.len > 0:
         let ctx = preparePContext(graph, module, idgen)
         for disp in getDispatchers(graph):
@@ -228,7 +237,8 @@ proc compilePipelineModule*(graph: ModuleGraph; fileIdx: FileIndex; flags: TSymF
     if sfMainModule in flags:
       if graph.config.projectIsStdin: s = stdin.llStreamOpen
       elif graph.config.projectIsCmd: s = llStreamOpen(graph.config.cmdInput)
-    discard processPipelineModule(graph, result, idGeneratorFromModule(result), s)
+    graph.config.profile(ppModule, toFilenameOption(graph.config, fileIdx, foCanonical)):
+      discard processPipelineModule(graph, result, idGeneratorFromModule(result), s)
   if result == nil:
     var cachedModules: seq[FileIndex] = @[]
     result = moduleFromRodFile(graph, fileIdx, cachedModules)
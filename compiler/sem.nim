@@ -18,10 +18,10 @@ import
   evaltempl, patterns, parampatterns, sempass2, linter, semmacrosanity,
   lowerings, plugins/active, lineinfos, int128,
   isolation_check, typeallowed, modulegraphs, enumtostr, concepts, astmsgs,
-  extccomp, layeredtable
+  extccomp, layeredtable, sighashes, compilerprofiler
 
 import vtables
-import std/[strtabs, math, tables, intsets, strutils, packedsets]
+import std/[strtabs, math, tables, intsets, strutils, packedsets, hashes]
 
 when not defined(leanCompiler):
   import spawn
@@ -522,7 +522,9 @@ proc semMacroExpr(c: PContext, n, nOrig: PNode, sym: PSym,
 
   #if c.evalContext == nil:
   #  c.evalContext = c.createEvalContext(emStatic)
-  result = evalMacroCall(c.module, c.idgen, c.graph, c.templInstCounter, n, nOrig, sym)
+  c.config.count(pcMacroExpansions)
+  c.config.profile(ppMacro, sym.name.s):
+    result = evalMacroCall(c.module, c.idgen, c.graph, c.templInstCounter, n, nOrig, sym)
   if efNoSemCheck notin flags:
     result = semAfterMacroCall(c, n, result, sym, flags, expectedType)
   if c.config.macrosToExpand.hasKey(sym.name.s):
@@ -813,9 +815,7 @@ proc semStmtAndGenerateGenerics(c: PContext, n: PNode): PNode =
   if c.config.cmd == cmdIdeTools:
     appendToModule(c.module, result)
   trackStmt(c, c.module, result, isTopLevel = true)
-  if optMultiMethods notin c.config.globalOptions and
-      c.config.selectedGC in {gcArc, gcOrc, gcAtomicArc} and
-      Feature.vtables in c.config.features:
+  if c.config.usesVTables:
     sortVTableDispatchers(c.graph)
 
     if sfMainModule in c.module.flags:
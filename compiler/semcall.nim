@@ -500,6 +500,79 @@ proc getMsgDiagnostic(c: PContext, flags: TExprFlags, n, f: PNode): string =
     if result.len == 0: result = errUndeclaredRoutine % ident
     else: result = errBadRoutine % [ident, result]
 
+proc visibleSymbols(c: PContext): int =
+  # grows whenever a symbol becomes visible in the current scope
+  result = c.lookupGeneration
+  for scope in allScopes(c.currentScope):
+    inc result, scope.symbols.counter
+
+proc callCacheKey(c: PContext; f, n: PNode; filter: TSymKinds;
+                  flags: TExprFlags; key: var CachedCall): bool =
+  ## Describes the call `n` in `key` and returns true if its resolution only
+  ## depends on `key`: a call by name outside of generics whose arguments
+  ## are already typed. Literals, constructors and routines are excluded as
+  ## their matches depend on more than their types.
+  if f.kind != nkIdent or c.inGenericContext > 0 or c.compilesContextId > 0 or
+      c.matchedConcept != nil or {nfDotField, nfDotSetter} * n.flags != {} or
+      efExplain in flags:
+    return false
+  key = CachedCall(ident: f.ident, scope: c.currentScope,
+                   visible: visibleSymbols(c), filter: filter, flags: flags)
+  for i in 1..<n.len:
+    let a = n[i]
+    if a.typ == nil or a.kind in nkLiterals + nkSymChoices + nkLambdaKinds +
+        {nkExprEqExpr, nkCurly, nkBracket, nkPar, nkTupleConstr} or
+        a.typ.kind in {tyTypeDesc, tyStatic, tyProc, tyNil, tyEmpty, tyVoid,
+                       tyError, tyFromExpr, tyUntyped, tyTyped, tyIterable} or
+        tfHasMeta in a.typ.flags or isIntLit(a.typ):
+      return false
+    let assignable = isAssignable(nil, a)
+    if assignable == arDiscriminant:
+      return false
+    # `let` variables can be passed to `out` parameters, see `isLValue`
+    let root = if assignable == arAddressableConst: getRoot(a) else: nil
+    key.args.add (a.typ, a.kind, assignable, root != nil and root.kind == skLet)
+  result = true
+
+proc hash(key: CachedCall): Hash =
+  result = hash(key.ident.id) !& hash(cast[int](key.scope)) !& hash(key.visible)
+  for a in key.args:
+    result = result !& hash(cast[int](a.typ)) !& ord(a.kind) !& ord(a.assignable)
+  result = !$result
+
+proc sameCall(a, b: CachedCall): bool =
+  result = a.ident == b.ident and a.scope == b.scope and
+    a.visible == b.visible and a.filter == b.filter and a.flags == b.flags and
+    a.args == b.args
+
+proc cachedOverload(c: PContext; n, orig: PNode; key: CachedCall;
+                    best: var TCandidate): bool =
+  ## Memoized overload resolution: if the same call was resolved before in
+  ## the same scope with the same visible symbols and argument types, only
+  ## the routine picked then is matched again. Only routines without generic
+  ## parameters are remembered, and a failed match falls back to checking
+  ## all candidates.
+  let entry = c.callCache.getOrDefault(hash(key))
+  if entry.sym == nil or not sameCall(entry, key):
+    return false
+  var z = initCandidate(c, entry.sym, nil, entry.symScope, false)
+  matches(c, n, orig, z)
+  result = z.state == csMatch
+  if result:
+    best = z
+
+proc cacheOverload(c: PContext; key: var CachedCall; best: TCandidate) =
+  let sym = best.calleeSym
+  if sym == nil or sym.kind notin {skProc, skFunc} or sym.ast == nil or
+      sym.ast[genericParamsPos].kind != nkEmpty or sym.typ == nil or
+      tfHasMeta in sym.typ.flags or sym.magic in {mArrGet, mArrPut}:
+    return
+  if c.callCache.len >= 10_000:
+    c.callCache.clear()
+  key.sym = sym
+  key.symScope = best.calleeScope
+  c.callCache[hash(key)] = key
+
 proc resolveOverloads(c: PContext, n, orig: PNode,
                       filter: TSymKinds, flags: TExprFlags,
                       errors: var CandidateErrors,
@@ -516,6 +589,12 @@ proc resolveOverloads(c: PContext, n, orig: PNode,
   else:
     initialBinding = nil
 
+  var key = default(CachedCall)
+  let cacheable = initialBinding == nil and
+    callCacheKey(c, f, n, filter, flags, key)
+  if cacheable and cachedOverload(c, n, orig, key, result):
+    return
+
   pickBestCandidate(c, f, n, orig, initialBinding,
                     filter, result, alt, errors, efExplain in flags,
                     errorsEnabled, flags)
@@ -595,6 +674,8 @@ proc resolveOverloads(c: PContext, n, orig: PNode,
         getProcHeader(c.config, result.calleeSym),
         getProcHeader(c.config, alt.calleeSym),
         args])
+  elif cacheable:
+    cacheOverload(c, key, result)
 
 proc bracketNotFoundError(c: PContext; n: PNode; flags: TExprFlags) =
   var errors: CandidateErrors = @[]
@@ -9,14 +9,15 @@
 
 ## This module contains the data structures for the semantic checking phase.
 
-import std/[tables, intsets, sets]
+import std/[tables, intsets, sets, hashes]
 
 when defined(nimPreviewSlimSystem):
   import std/assertions
 
 import
   options, ast, msgs, idents, renderer,
-  magicsys, vmdef, modulegraphs, lineinfos, pathutils, layeredtable
+  magicsys, vmdef, modulegraphs, lineinfos, pathutils, layeredtable,
+  parampatterns
 
 import ic / ic
 
@@ -92,6 +93,20 @@ type
       exceptSet*: IntSet         # of PIdent.id
 
   PContext* = ref TContext
+  CachedCall* = object
+    ## A call that `resolveOverloads` resolved to a routine without generic
+    ## parameters; see `semcall.cachedOverload`.
+    ident*: PIdent
+    scope*: PScope      # the scope of the call; kept alive by the cache
+    visible*: int       # changes when symbols are added to `scope`, its
+                        # parents or the imports
+    filter*: TSymKinds
+    flags*: TExprFlags
+    args*: seq[tuple[typ: PType, kind: TNodeKind, assignable: TAssignableResult,
+                     letRoot: bool]]
+    sym*: PSym
+    symScope*: int
+
   TContext* = object of TPassContext # a context represents the module
                                      # that is currently being compiled
     enforceVoidContext*: PType
@@ -172,6 +187,9 @@ type
     importModuleLookup*: Table[int, seq[int]] # (module.ident.id, [module.id])
     skipTypes*: seq[PNode] # used to skip types between passes in type section. So far only used for inheritance, sets and generic bodies.
     inTypeofContext*: int
+    lookupGeneration*: int # incremented whenever the imports change or a
+                           # symbol is replaced in a scope
+    callCache*: Table[Hash, CachedCall] # see `semcall.cachedOverload`
   TBorrowState* = enum
     bsNone, bsReturnNotMatch, bsNoDistinct, bsGeneric, bsNotSupported, bsMatch
 
@@ -89,7 +89,8 @@ proc sameInstantiation(a, b: TInstantiation): bool =
 proc genericCacheGet(g: ModuleGraph; genericSym: PSym, entry: TInstantiation;
                      id: CompilesId): PSym =
   result = nil
-  for inst in procInstCacheItems(g, genericSym):
+  # only the instantiations with the same `procInstKey` can be the same:
+  for inst in procInstCacheItems(g, genericSym, procInstKey(entry), procInstKey):
     if (inst.compilesId == 0 or inst.compilesId == id) and sameInstantiation(entry, inst[]):
       return inst.sym
 
@@ -454,7 +455,9 @@ proc generateInstance(c: PContext, fn: PSym, pt: LayeredIdTable,
       pragma(c, result, n[pragmasPos], allRoutinePragmas)
     if isNil(n[bodyPos]):
       n[bodyPos] = copyTree(getBody(c.graph, fn))
-    instantiateBody(c, n, fn.typ.n, result, fn)
+    c.config.count(pcInstantiations)
+    c.config.profile(ppInstantiate, fn.name.s):
+      instantiateBody(c, n, fn.typ.n, result, fn)
     c.optionStack[^1].otherPragmas = otherPragmas
     sideEffectsCheck(c, result)
     if result.magic notin {mSlice, mTypeOf}:
@@ -784,6 +784,8 @@ proc semTemplateDef(c: PContext, n: PNode): PNode =
       #wrongRedefinition(c, n.info, proto.name.s, proto.info)
       message(c.config, n.info, warnImplicitTemplateRedefinition, s.name.s)
     symTabReplace(c.currentScope.symbols, proto, s)
+    # the table keeps its size, so calls resolved before have to know
+    inc c.lookupGeneration
   if n[patternPos].kind != nkEmpty:
     c.patterns.add(s)
 
@@ -12,7 +12,7 @@
 import std / tables
 
 import ast, astalgo, msgs, types, magicsys, semdata, renderer, options,
-  lineinfos, modulegraphs, layeredtable
+  lineinfos, modulegraphs, layeredtable, sighashes
 
 when defined(nimPreviewSlimSystem):
   import std/assertions
@@ -37,7 +37,7 @@ proc searchInstTypes*(g: ModuleGraph; key: PType): PType =
   if not (genericTyp.kind == tyGenericBody and
       genericTyp.sym != nil): return
 
-  for inst in typeInstCacheItems(g, genericTyp.sym):
+  for inst in typeInstCacheItems(g, genericTyp.sym, typeInstKey(key), typeInstKey):
     if inst.id == key.id: return inst
     if inst.kidsLen < key.kidsLen:
       # XXX: This happens for prematurely cached
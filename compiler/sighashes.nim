@@ -10,7 +10,7 @@
 ## Computes hash values for routine (proc, method etc) signatures.
 
 import ast, ropes, modulegraphs, options, msgs, pathutils
-from std/hashes import Hash
+from std/hashes import Hash, `!&`, `!$`
 import std/tables
 import types
 import ../dist/checksums/src/checksums/md5
@@ -332,6 +332,58 @@ proc hashOwner*(s: PSym): SigHash =
 
   md5Final c, result.MD5Digest
 
+proc instKeyAux(t: PType; depth: int; complete: var bool): Hash =
+  # Hashes only what `sameTypeAux` compares for `dcEq`, so that types that
+  # `compareTypes` considers equal get equal hashes. Unlike `hashType` this
+  # does not walk into objects and is cheap.
+  if t == nil: return 0
+  var a = skipTypes(t, {tyAlias})
+  while a.kind == tyUserTypeClass and tfResolved in a.flags:
+    a = skipTypes(a.last, {tyAlias})
+  result = ord(a.kind)
+  case a.kind
+  of tyForward:
+    # turns into the declared type in place later
+    complete = false
+  of tyEnum:
+    result = result !& a.id
+  of tyObject, tyDistinct:
+    # see `ifFastObjectTypeCheckFailed`
+    if tfFromGeneric in a.flags:
+      result = result !& 1 !& (if a.sym != nil: a.sym.id else: 0)
+    else:
+      result = result !& a.id
+  of tySequence, tyOpenArray, tySet, tyRef, tyPtr, tyVar, tyLent, tySink,
+     tyUncheckedArray, tyArray, tyVarargs, tyOwned, tyTuple:
+    if depth < 3:
+      for k in a.kids:
+        result = result !& instKeyAux(k, depth + 1, complete)
+  else:
+    discard
+
+proc typeInstKey*(t: PType): Hash =
+  ## The key of a generic type instantiation or invocation `t` in the index
+  ## over `typeInstCache`. Only the first generic argument is hashed: an
+  ## instantiation is cached before its arguments and body are added.
+  result = unknownInstKey
+  var complete = t.kidsLen > FirstGenericParamAt
+  if complete:
+    let h = !$instKeyAux(t[FirstGenericParamAt], 0, complete)
+    if complete: result = h
+
+proc procInstKey*(inst: TInstantiation): Hash =
+  ## The key of a generic routine instantiation in the index over
+  ## `procInstCache`.
+  var complete = true
+  result = inst.concreteTypes.len
+  for t in inst.concreteTypes:
+    result = result !& instKeyAux(t, 0, complete)
+  result = !$result
+  if not complete: result = unknownInstKey
+
+proc procInstKey*(inst: PInstantiation): Hash =
+  result = procInstKey(inst[])
+
 proc sigHash*(s: PSym; conf: ConfigRef): SigHash =
   if s.kind in routineKinds and s.typ != nil:
     result = hashProc(s, conf)
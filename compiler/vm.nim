@@ -563,6 +563,10 @@ proc rawExecute(c: PCtx, start: int, tos: PStackFrame): TFullReg =
       move(regs, tos.slots)
     var regs: seq[TFullReg] # alias to tos.slots for performance
     updateRegsAlias
+  var executed = 0 # for `--profileCompiler`, added up once per run
+  defer:
+    if c.config.profiler != nil:
+      inc c.config.profiler.counters[pcVmInstructions], executed
   #echo "NEW RUN ------------------------"
   while true:
     #{.computedGoto.}
@@ -584,6 +588,7 @@ proc rawExecute(c: PCtx, start: int, tos: PStackFrame): TFullReg =
       # other useful variables: c.loopIterations
       echo "$# [$#] $#" % [c.config$info, $instr.opcode, c.config.sourceLine(info)]
     c.profiler.enter(c, tos)
+    inc executed
     case instr.opcode
     of opcEof: return regs[ra]
     of opcRet:
@@ -44,6 +44,7 @@ when defined(nimPreviewSlimSystem):
 
 import tools / kochdocs
 import tools / deps
+import tools / kochbench
 
 const VersionAsString = system.NimVersion
 
@@ -103,6 +104,8 @@ Commands for core developers:
   tests [options]          run the testsuite (run a subset of tests by
                            specifying a category, e.g. `tests cat async`)
   temp options             creates a temporary compiler for testing
+  benchcompiler [options]  measures the compiler on a fixed corpus and compares
+                           the results with a baseline (`--save` stores one)
 """
 
 let kochExe* = when isMainModule: os.getAppFilename() # always correct when koch is main program, even if `koch` exe renamed e.g.: `nim c -o:koch_debug koch.nim`
@@ -750,6 +753,7 @@ when isMainModule:
       of "runci": runCI(op.cmdLineRest)
       of "test", "tests": tests(op.cmdLineRest)
       of "temp": temp(op.cmdLineRest)
+      of "benchcompiler": benchCompiler(op.cmdLineRest)
       of "xtemp": xtemp(op.cmdLineRest)
       of "wintools": bundleWinTools(op.cmdLineRest)
       of "nimble": bundleNimbleExe(latest, op.cmdLineRest)
@@ -326,44 +326,59 @@ template `<-`(a, b) =
   else:
     copyMem(addr(a), addr(b), sizeof(T))
 
-proc mergeAlt[T](a, b: var openArray[T], lo, m, hi: int,
-              cmp: proc (x, y: T): int {.closure.}, order: SortOrder) {.effectsOf: cmp.} =
+template mergeAlt(a, b, lo0, m0, hi0, cmp, order: untyped) =
+  # `cmp` is expanded in place, so that the shortcut versions of `sort`
+  # call `system.cmp` directly instead of through a closure.
+  #
   # Optimization: If max(left) <= min(right) there is nothing to do!
   # 1 2 3 4 ## 5 6 7 8
   # -> O(n) for sorted arrays.
   # On random data this saves up to 40% of mergeAlt calls.
-  if cmp(a[m], a[m+1]) * order <= 0: return
-  var j = lo
-  # copy a[j..m] into b:
-  assert j <= m
-  when onlySafeCode:
-    var bb = 0
-    while j <= m:
-      b[bb] <- a[j]
-      inc(bb)
-      inc(j)
-  else:
-    copyMem(addr(b[0]), addr(a[j]), sizeof(T)*(m-j+1))
-    j = m+1
-  var i = 0
-  var k = lo
-  # copy proper element back:
-  while k < j and j <= hi:
-    if cmp(b[i], a[j]) * order <= 0:
-      a[k] <- b[i]
-      inc(i)
+  let m = m0
+  if cmp(a[m], a[m+1]) * order > 0:
+    let hi = hi0
+    var j = lo0
+    # copy a[j..m] into b:
+    assert j <= m
+    when onlySafeCode:
+      var bb = 0
+      while j <= m:
+        b[bb] <- a[j]
+        inc(bb)
+        inc(j)
     else:
-      a[k] <- a[j]
-      inc(j)
-    inc(k)
-  # copy rest of b:
-  when onlySafeCode:
-    while k < j:
-      a[k] <- b[i]
+      copyMem(addr(b[0]), addr(a[j]), sizeof(T)*(m-j+1))
+      j = m+1
+    var i = 0
+    var k = lo0
+    # copy proper element back:
+    while k < j and j <= hi:
+      if cmp(b[i], a[j]) * order <= 0:
+        a[k] <- b[i]
+        inc(i)
+      else:
+        a[k] <- a[j]
+        inc(j)
       inc(k)
-      inc(i)
-  else:
-    if k < j: copyMem(addr(a[k]), addr(b[i]), sizeof(T)*(j-k))
+    # copy rest of b:
+    when onlySafeCode:
+      while k < j:
+        a[k] <- b[i]
+        inc(k)
+        inc(i)
+    else:
+      if k < j: copyMem(addr(a[k]), addr(b[i]), sizeof(T)*(j-k))
+
+template mergeSort(a, cmp, order: untyped) =
+  var n = a.len
+  var b = newSeq[T](n div 2)
+  var s = 1
+  while s < n:
+    var m = n-1-s
+    while m >= 0:
+      mergeAlt(a, b, max(m-s+1, 0), m, m+s, cmp, order)
+      dec(m, s*2)
+    s = s*2
 
 func sort*[T](a: var openArray[T],
               cmp: proc (x, y: T): int {.closure.},
@@ -408,25 +423,19 @@ func sort*[T](a: var openArray[T],
       else: -1
     sort(d, myCmp)
     assert d == ["fo", "qux", "boo", "barr"]
-  var n = a.len
-  var b = newSeq[T](n div 2)
-  var s = 1
-  while s < n:
-    var m = n-1-s
-    while m >= 0:
-      mergeAlt(a, b, max(m-s+1, 0), m, m+s, cmp, order)
-      dec(m, s*2)
-    s = s*2
+  mergeSort(a, cmp, order)
 
-proc sort*[T](a: var openArray[T], order = SortOrder.Ascending) = sort[T](a,
-    system.cmp[T], order)
+proc sort*[T](a: var openArray[T], order = SortOrder.Ascending) =
   ## Shortcut version of `sort` that uses `system.cmp[T]` as the comparison function.
+  ## The comparison is inlined into the sort instead of being called
+  ## through a closure.
   ##
   ## **See also:**
   ## * `sort func<#sort,openArray[T],proc(T,T)>`_
   ## * `sorted proc<#sorted,openArray[T],proc(T,T)>`_ sorted by `cmp` in the specified order
   ## * `sorted proc<#sorted,openArray[T]>`_
   ## * `sortedByIt template<#sortedByIt.t,untyped,untyped>`_
+  mergeSort(a, system.cmp, order)
 
 proc sorted*[T](a: openArray[T], cmp: proc(x, y: T): int {.closure.},
                 order = SortOrder.Ascending): seq[T] {.effectsOf: cmp.} =
@@ -466,7 +475,10 @@ proc sorted*[T](a: openArray[T], order = SortOrder.Ascending): seq[T] =
     assert b == @[1, 2, 3, 4, 5]
     assert c == @[5, 4, 3, 2, 1]
     assert d == @["adam", "brian", "cat", "dande"]
-  sorted[T](a, system.cmp[T], order)
+  result = newSeq[T](a.len)
+  for i in 0 .. a.high:
+    result[i] = a[i]
+  sort(result, order)
 
 template sortedByIt*(seq1, op: untyped): untyped =
   ## Convenience template around the `sorted` proc to reduce typing.
@@ -504,6 +516,107 @@ template sortedByIt*(seq1, op: untyped): untyped =
     result = cmp(a, b))
   result
 
+func radixKey[T](x: T, order: SortOrder): uint64 {.inline.} =
+  # Maps `x` to an unsigned integer of the same width with the same order.
+  const bits = 8 * sizeof(T)
+  const mask = not 0'u64 shr (64 - bits)
+  when T is SomeFloat:
+    when sizeof(T) == 4:
+      let u = uint64(cast[uint32](x))
+    else:
+      let u = cast[uint64](x)
+    # negative numbers compare reversed, so all their bits are flipped
+    result = if (u shr (bits - 1)) != 0: not u and mask else: u or (1'u64 shl (bits - 1))
+  elif T is SomeSignedInt:
+    result = (cast[uint64](BiggestInt(x)) xor (1'u64 shl (bits - 1))) and mask
+  else:
+    result = uint64(x)
+  if order == Descending:
+    result = not result and mask
+
+template radixSortImpl(a: untyped, width: int, keyOf: untyped) =
+  # Least significant digit radix sort of `a` on the lowest `width` bytes
+  # of `keyOf(x)`, one byte per pass. All histograms are built in a single
+  # pass and bytes that are the same for every element are skipped.
+  let n = a.len
+  if n > 1:
+    var counts: array[8, array[256, int]]
+    for x in a:
+      let key = keyOf(x)
+      for d in 0 ..< width:
+        inc counts[d][int((key shr (8 * d)) and 0xFF)]
+    var buf = newSeq[typeof(a[0])](n)
+    var inBuf = false
+    template pass(src, dst, d: untyped) =
+      var sum = 0
+      for c in 0 .. 255:
+        let k = counts[d][c]
+        counts[d][c] = sum
+        sum += k
+      for i in 0 ..< n:
+        let c = int((keyOf(src[i]) shr (8 * d)) and 0xFF)
+        dst[counts[d][c]] <- src[i]
+        inc counts[d][c]
+    for d in 0 ..< width:
+      if counts[d][int((keyOf(a[0]) shr (8 * d)) and 0xFF)] != n:
+        if inBuf: pass(buf, a, d)
+        else: pass(a, buf, d)
+        inBuf = not inBuf
+    if inBuf:
+      for i in 0 ..< n:
+        a[i] <- buf[i]
+
+proc radixSort*[T: SomeNumber | char](a: var openArray[T],
+                                      order = SortOrder.Ascending) {.since: (2, 3).} =
+  ## Sorts the numbers or characters in `a` in the specified `order` with a
+  ## least significant digit radix sort. This takes `sizeof(T)` passes over
+  ## `a` and does not compare elements, which for large arrays is several
+  ## times faster than `sort`. It uses a temporary sequence of length `a.len`.
+  ##
+  ## Floats are ordered like `cmp` orders them, except that `-0.0` comes
+  ## before `0.0`; NaNs are placed at the ends.
+  ##
+  ## **See also:**
+  ## * `radixSort proc<#radixSort,openArray[T],proc(T),SortOrder>`_ for sorting by a numeric key
+  ## * `sort proc<#sort,openArray[T]>`_
+  runnableExamples:
+    var a = [3, -1, 300, 0, -200]
+    a.radixSort()
+    assert a == [-200, -1, 0, 3, 300]
+    var b = [2.5, -0.5, 1e10, -3.0]
+    b.radixSort(Descending)
+    assert b == [1e10, 2.5, -0.5, -3.0]
+  template keyOf(x: T): uint64 = radixKey(x, order)
+  radixSortImpl(a, sizeof(T), keyOf)
+
+proc radixSort*[T; K: SomeNumber | char](a: var openArray[T],
+                                         key: proc (x: T): K {.closure.},
+                                         order = SortOrder.Ascending) {.since: (2, 3), effectsOf: key.} =
+  ## Sorts `a` by `key` in the specified `order` with a least significant
+  ## digit radix sort. The sort is stable; `key` is called once per element
+  ## and the elements themselves are only moved once, into their final place.
+  ##
+  ## **See also:**
+  ## * `radixSort proc<#radixSort,openArray[T],SortOrder>`_
+  ## * `sortedByIt template<#sortedByIt.t,untyped,untyped>`_
+  runnableExamples:
+    type Person = tuple[name: string, age: int]
+    var people: seq[Person] = @[("p1", 60), ("p2", 20), ("p3", 30), ("p4", 30)]
+    people.radixSort(proc (p: Person): int = p.age)
+    assert people == @[("p2", 20), ("p3", 30), ("p4", 30), ("p1", 60)]
+  let n = a.len
+  if n < 2: return
+  var keys = newSeq[tuple[key: uint64, index: int]](n)
+  for i in 0 ..< n:
+    keys[i] = (radixKey(key(a[i]), order), i)
+  template keyOf(x: tuple[key: uint64, index: int]): uint64 = x.key
+  radixSortImpl(keys, sizeof(K), keyOf)
+  var tmp = newSeq[T](n)
+  for i in 0 ..< n:
+    tmp[i] <- a[keys[i].index]
+  for i in 0 ..< n:
+    a[i] <- tmp[i]
+
 func isSorted*[T](a: openArray[T],
                  cmp: proc(x, y: T): int {.closure.},
                  order = SortOrder.Ascending): bool {.effectsOf: cmp.} =
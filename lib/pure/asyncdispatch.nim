@@ -226,15 +226,21 @@
 ## ``none`` can be used when a library supports both a synchronous and
 ## asynchronous API, to disable the latter.
 
-import std/[os, tables, strutils, times, heapqueue, options, asyncstreams]
+import std/[os, tables, strutils, times, options, asyncstreams]
 import std/[math, monotimes]
 import std/asyncfutures except callSoon
+import std/private/timerwheel
 
 import std/[nativesockets, net, deques]
 
 when defined(nimPreviewSlimSystem):
   import std/[assertions, syncio]
 
+when compileOption("threads"):
+  import std/locks
+  when defined(nimPreviewSlimSystem):
+    import std/typedthreads
+
 export Port, SocketFlag
 export asyncfutures except callSoon
 export asyncstreams
@@ -242,32 +248,83 @@ export asyncstreams
 # TODO: Check if yielded future is nil and throw a more meaningful exception
 
 type
+  DispatcherMetrics* = object
+    ## Event loop statistics of a dispatcher, see `metrics`.
+    ticks*: int             ## Number of iterations of the event loop.
+    events*: int            ## Readiness or completion events processed.
+    lastTickEvents*: int    ## Events processed by the last iteration.
+    maxTickEvents*: int     ## Most events processed by a single iteration.
+    timersFired*: int       ## Timers that have expired.
+    callbacksRun*: int      ## Callbacks run from the `callSoon` queue.
+    busyTime*: Duration     ## Time spent in event handlers, timers and
+                            ## callbacks, excluding the wait for events.
+    batchSize*: int         ## Current capacity of the readiness batch
+                            ## passed to the selector. Always 1 on Windows,
+                            ## where every iteration dequeues one completion.
+    pendingTimers*: int     ## Timers that have not expired yet.
+    pendingCallbacks*: int  ## Callbacks waiting in the `callSoon` queue.
+
   PDispatcherBase = ref object of RootRef
-    timers*: HeapQueue[tuple[finishAt: MonoTime, fut: Future[void]]]
+    timers*: TimerWheel[Future[void]]
     callbacks*: Deque[proc () {.gcsafe.}]
+    stats: DispatcherMetrics
 
 proc processTimers(
   p: PDispatcherBase, didSomeWork: var bool
 ): Option[int] {.inline.} =
-  # Pop the timers in the order in which they will expire (smaller `finishAt`).
-  var count = p.timers.len
-  let t = getMonoTime()
-  while count > 0 and t >= p.timers[0].finishAt:
-    p.timers.pop().fut.complete()
-    dec count
+  # Complete the timers in the order in which they expired (smaller deadline).
+  # Timers added by their callbacks are processed on the next call.
+  var expired: seq[Future[void]]
+  p.timers.advance(getMonoTime(), expired)
+  for fut in expired:
+    fut.complete()
     didSomeWork = true
+  p.stats.timersFired += expired.len
 
   # Return the number of milliseconds in which the next timer will expire.
-  if p.timers.len == 0: return
+  result = p.timers.nextTimeout(getMonoTime())
 
-  let millisecs = (p.timers[0].finishAt - getMonoTime()).inMilliseconds
-  return some(millisecs.int + 1)
+proc timerResolution*(p: PDispatcherBase): Duration =
+  ## Returns the granularity of the timers of dispatcher `p`.
+  p.timers.resolution
+
+proc `timerResolution=`*(p: PDispatcherBase, resolution: Duration) =
+  ## Rounds the deadlines of the timers of dispatcher `p` (`sleepAsync`,
+  ## `withTimeout`) up to multiples of `resolution`, 1 millisecond by default.
+  ##
+  ## A coarser resolution batches timers that expire close to each other
+  ## into a single wake-up of the event loop, at the cost of firing them up
+  ## to `resolution` late. Pending timers are rounded to the new resolution.
+  p.timers.resolution = resolution
 
 proc processPendingCallbacks(p: PDispatcherBase; didSomeWork: var bool) =
   while p.callbacks.len > 0:
     var cb = p.callbacks.popFirst()
     cb()
     didSomeWork = true
+    inc p.stats.callbacksRun
+
+proc recordTick(p: PDispatcherBase; events: int; busySince: MonoTime) {.inline.} =
+  inc p.stats.ticks
+  p.stats.events += events
+  p.stats.lastTickEvents = events
+  p.stats.maxTickEvents = max(p.stats.maxTickEvents, events)
+  p.stats.busyTime += getMonoTime() - busySince
+
+proc metrics*(p: PDispatcherBase): DispatcherMetrics =
+  ## Returns the event loop statistics of dispatcher `p`, for example to
+  ## monitor how saturated the event loop is.
+  runnableExamples:
+    let m = getGlobalDispatcher().metrics
+    assert m.pendingCallbacks == 0
+  result = p.stats
+  result.pendingTimers = p.timers.len
+  result.pendingCallbacks = p.callbacks.len
+
+proc resetMetrics*(p: PDispatcherBase) =
+  ## Resets the counters of `metrics`.
+  let batchSize = p.stats.batchSize
+  p.stats = DispatcherMetrics(batchSize: batchSize)
 
 proc adjustTimeout(
   p: PDispatcherBase, pollTimeout: int, nextTimer: Option[int]
@@ -348,8 +405,9 @@ when defined(windows) or defined(nimdoc):
     new result
     result.ioPort = createIoCompletionPort(INVALID_HANDLE_VALUE, 0, 0, 1)
     result.handles = initHashSet[AsyncFD]()
-    result.timers.clear()
+    result.timers = initTimerWheel[Future[void]]()
     result.callbacks = initDeque[proc () {.closure, gcsafe.}](64)
+    result.stats.batchSize = 1
 
   var gDisp{.threadvar.}: owned PDispatcher ## Global dispatcher
 
@@ -411,6 +469,8 @@ when defined(windows) or defined(nimdoc):
     let res = getQueuedCompletionStatus(p.ioPort,
         addr lpNumberOfBytesTransferred, addr lpCompletionKey,
         cast[ptr POVERLAPPED](addr customOverlapped), llTimeout).bool
+    let busySince = getMonoTime()
+    let events = ord(res or customOverlapped != nil)
     result = true
     # For 'gcDestructors' the destructor of 'customOverlapped' will
     # be called at the end and we are the only owner here. This means
@@ -454,6 +514,7 @@ when defined(windows) or defined(nimdoc):
     discard processTimers(p, result)
     # Callback queue processing
     processPendingCallbacks(p, result)
+    p.recordTick(events, busySince)
 
 
   var acceptEx: WSAPROC_ACCEPTEX
@@ -1180,6 +1241,11 @@ else:
                                      # associated with file/socket descriptor.
     InitDelayedCallbackListSize = 64 # initial size of delayed callbacks
                                      # queue.
+    MinReadyKeys = 64                # initial size of the readiness batch,
+    MaxReadyKeys = 4096              # which doubles while the selector
+                                     # keeps filling it,
+    ShrinkReadyKeysAfter = 256       # and halves after this many iterations
+                                     # that used at most a quarter of it.
   type
     AsyncFD* = distinct cint
     Callback* = proc (fd: AsyncFD): bool {.closure, gcsafe.}
@@ -1192,6 +1258,8 @@ else:
 
     PDispatcher* = ref object of PDispatcherBase
       selector: Selector[AsyncData]
+      readyKeys: seq[ReadyKey]
+      sparseTicks: int # iterations in a row that used little of the batch
       when defined(genode):
         signalHandler: SignalHandler
 
@@ -1207,7 +1275,9 @@ else:
   proc newDispatcher*(): owned(PDispatcher) =
     new result
     result.selector = newSelector[AsyncData]()
-    result.timers.clear()
+    result.readyKeys = newSeq[ReadyKey](MinReadyKeys)
+    result.stats.batchSize = MinReadyKeys
+    result.timers = initTimerWheel[Future[void]]()
     result.callbacks = initDeque[proc () {.closure, gcsafe.}](InitDelayedCallbackListSize)
     when defined(genode):
       let entrypoint = ep(cast[GenodeEnv](runtimeEnv))
@@ -1282,63 +1352,67 @@ else:
     not p.selector.isEmpty() or p.timers.len != 0 or p.callbacks.len != 0
 
   proc prependSeq(dest: var seq[Callback]; src: sink seq[Callback]) =
-    var old = move dest
-    dest = src
-    for i in 0..high(old):
-      dest.add(move old[i])
+    if dest.len == 0:
+      dest = move src
+      return
+    # `dest` only grows if callbacks stayed alive while new ones were added
+    let n = src.len
+    dest.setLen(dest.len + n)
+    for i in countdown(dest.high, n):
+      dest[i] = move dest[i - n]
+    for i in 0 ..< n:
+      dest[i] = move src[i]
+
+  proc runCallbacks(fd: AsyncFD; list: var seq[Callback]) =
+    # Invoke every callback of `list`, until one returns `false` (which means
+    # callback wants to stay alive). That one and the remaining callbacks are
+    # left in `list`, in the order they have been inserted, as they are all
+    # waiting for the same event on the same fd.
+    var done = 0
+    while done < list.len:
+      if not list[done](fd): break
+      inc done
+    if done > 0:
+      for i in done ..< list.len:
+        list[i - done] = move list[i]
+      list.setLen(list.len - done)
 
   proc processBasicCallbacks(
-    fd: AsyncFD, event: Event
+    fd: AsyncFD, events: set[Event]
   ): tuple[readCbListCount, writeCbListCount: int] =
-    # Process pending descriptor and AsyncEvent callbacks.
+    # Process pending descriptor and AsyncEvent callbacks, the read callbacks
+    # if `Event.Read` is in `events` and then the write callbacks if
+    # `Event.Write` is.
     #
-    # Invoke every callback stored in `rwlist`, until one
-    # returns `false` (which means callback wants to stay
-    # alive). In such case all remaining callbacks will be added
-    # to `rwlist` again, in the order they have been inserted.
-    #
-    # `rwlist` associated with file descriptor MUST BE emptied before
+    # The list associated with file descriptor MUST BE emptied before
     # dispatching callback (See https://github.com/nim-lang/Nim/issues/5128),
-    # or it can be possible to fall into endless cycle.
-    var curList: seq[Callback]
-
+    # or it can be possible to fall into endless cycle. The lists are moved
+    # out of the descriptor's data instead of copied, and the callbacks that
+    # stay alive are put back with the same lookup that takes out the write
+    # callbacks, so both directions need three lookups. Nothing is allocated
+    # unless callbacks that stay alive meet new ones added meanwhile.
+    var readList, writeList: seq[Callback]
     let selector = getGlobalDispatcher().selector
     withData(selector, fd.int, fdData):
-      case event
-      of Event.Read:
-        #shallowCopy(curList, fdData.readList)
-        curList = move fdData.readList
-        fdData.readList = newSeqOfCap[Callback](InitCallbackListSize)
-      of Event.Write:
-        #shallowCopy(curList, fdData.writeList)
-        curList = move fdData.writeList
-        fdData.writeList = newSeqOfCap[Callback](InitCallbackListSize)
-      else:
-        assert false, "Cannot process callbacks for " & $event
-
-    let newLength = max(len(curList), InitCallbackListSize)
-    var newList = newSeqOfCap[Callback](newLength)
-
-    var eventsExtinguished = false
-    for cb in curList:
-      if eventsExtinguished:
-        newList.add(cb)
-      elif not cb(fd):
-        # Callback wants to be called again.
-        newList.add(cb)
-        # This callback has returned with EAGAIN, so we don't need to
-        # call any other callbacks as they are all waiting for the same event
-        # on the same fd.
-        # We do need to ensure they are called again though.
-        eventsExtinguished = true
+      if Event.Read in events: readList = move fdData.readList
+      else: writeList = move fdData.writeList
+    if Event.Read in events:
+      runCallbacks(fd, readList)
+      if Event.Write in events:
+        var found = false
+        withData(selector, fd.int, fdData):
+          found = true
+          prependSeq(fdData.readList, move readList)
+          writeList = move fdData.writeList
+        if not found:
+          # Descriptor was unregistered in callback via `unregister()`.
+          return (-1, -1)
+    runCallbacks(fd, writeList)
 
     withData(selector, fd.int, fdData) do:
       # Descriptor is still present in the queue.
-      case event
-      of Event.Read: prependSeq(fdData.readList, newList)
-      of Event.Write: prependSeq(fdData.writeList, newList)
-      else:
-        assert false, "Cannot process callbacks for " & $event
+      if readList.len > 0: prependSeq(fdData.readList, move readList)
+      if writeList.len > 0: prependSeq(fdData.writeList, move writeList)
 
       result.readCbListCount = len(fdData.readList)
       result.writeCbListCount = len(fdData.writeList)
@@ -1402,29 +1476,32 @@ else:
         "No handles or timers registered in dispatcher.")
 
     result = false
-    var keys: array[64, ReadyKey]
+    # The batch is taken out of the dispatcher while it is processed, so that
+    # a nested `poll` from a callback gets a buffer of its own.
+    var keys = move p.readyKeys
+    if keys.len == 0: keys.setLen(MinReadyKeys)
     let nextTimer = processTimers(p, result)
     var count =
       p.selector.selectInto(adjustTimeout(p, timeout, nextTimer), keys)
+    let busySince = getMonoTime()
     for i in 0..<count:
       let fd = keys[i].fd.AsyncFD
       let events = keys[i].events
       var (readCbListCount, writeCbListCount) = (0, 0)
 
-      if Event.Read in events or events == {Event.Error}:
+      let basic =
+        if events == {Event.Error}: {Event.Read, Event.Write}
+        else: events * {Event.Read, Event.Write}
+      if basic != {}:
+        # one call for both directions, see `processBasicCallbacks`
         (readCbListCount, writeCbListCount) =
-          processBasicCallbacks(fd, Event.Read)
-        result = true
-
-      if Event.Write in events or events == {Event.Error}:
-        (readCbListCount, writeCbListCount) =
-          processBasicCallbacks(fd, Event.Write)
+          processBasicCallbacks(fd, basic)
         result = true
 
       var isCustomEvent = false
       if Event.User in events:
         (readCbListCount, writeCbListCount) =
-          processBasicCallbacks(fd, Event.Read)
+          processBasicCallbacks(fd, {Event.Read})
         isCustomEvent = true
         if readCbListCount == 0:
           p.selector.unregister(fd.int)
@@ -1451,6 +1528,23 @@ else:
     # Callback queue processing
     processPendingCallbacks(p, result)
 
+    # A full batch means more descriptors may be ready than were returned,
+    # so serve them with fewer `epoll_wait`/`kevent` calls from now on. Once
+    # the load drops, the batch shrinks again, to keep it small in the cache.
+    if count == keys.len and keys.len < MaxReadyKeys:
+      keys.setLen(keys.len * 2)
+      p.sparseTicks = 0
+    elif count <= keys.len div 4 and keys.len > MinReadyKeys:
+      inc p.sparseTicks
+      if p.sparseTicks >= ShrinkReadyKeysAfter:
+        keys = newSeq[ReadyKey](keys.len div 2)
+        p.sparseTicks = 0
+    else:
+      p.sparseTicks = 0
+    p.stats.batchSize = keys.len
+    p.readyKeys = move keys
+    p.recordTick(count, busySince)
+
   proc recv*(socket: AsyncFD, size: int,
              flags = {SocketFlag.SafeDisconn}): owned(Future[string]) =
     var retFuture = newFuture[string]("recv")
@@ -1692,6 +1786,123 @@ else:
     data.readList.add(cb)
     p.selector.registerEvent(SelectEvent(ev), data)
 
+when compileOption("threads"):
+  const asyncBlockingThreads* {.intdefine.} = 4
+    ## Number of worker threads that run the blocking operations of
+    ## `runBlocking` and `asyncfile`. Change it with
+    ## `-d:asyncBlockingThreads=N`.
+
+  type
+    BlockingProc* = proc (arg: pointer): int {.nimcall, gcsafe.}
+      ## A blocking operation for `runBlocking`. It runs on a worker thread,
+      ## so it must not touch memory that is managed by the garbage
+      ## collector of the calling thread other than through `arg`.
+
+    BlockingJob = object
+      fn: BlockingProc
+      arg: pointer
+      res: int
+      id: int
+      next: ptr BlockingJob
+
+    BlockingPool = object
+      lock: Lock
+      cond: Cond
+      head, tail: ptr BlockingJob # submitted jobs, in FIFO order
+      done: ptr BlockingJob       # finished jobs, in no particular order
+      event: AsyncEvent
+      workers: array[asyncBlockingThreads, Thread[ptr BlockingPool]]
+
+  var
+    blockingPool {.threadvar.}: ptr BlockingPool
+    blockingJobs {.threadvar.}: Table[int, Future[int]]
+    blockingJobId {.threadvar.}: int
+    blockingEventRegistered {.threadvar.}: bool
+
+  proc blockingWorker(pool: ptr BlockingPool) {.thread.} =
+    while true:
+      acquire(pool.lock)
+      while pool.head == nil:
+        wait(pool.cond, pool.lock)
+      let job = pool.head
+      pool.head = job.next
+      if pool.head == nil: pool.tail = nil
+      release(pool.lock)
+
+      job.res = job.fn(job.arg)
+
+      acquire(pool.lock)
+      job.next = pool.done
+      pool.done = job
+      release(pool.lock)
+      trigger(pool.event)
+
+  proc completeBlockingJobs(fd: AsyncFD): bool {.gcsafe.} =
+    # Called on the dispatcher thread whenever a worker finished a job.
+    # Stays registered as long as jobs are pending, so that an idle pool does
+    # not count as a pending operation of the dispatcher.
+    let pool = blockingPool
+    acquire(pool.lock)
+    var job = pool.done
+    pool.done = nil
+    release(pool.lock)
+    while job != nil:
+      let next = job.next
+      var fut: Future[int]
+      if blockingJobs.pop(job.id, fut):
+        fut.complete(job.res)
+      deallocShared(job)
+      job = next
+    result = blockingJobs.len == 0
+    blockingEventRegistered = not result
+
+  proc runBlocking*(fn: BlockingProc, arg: pointer): owned(Future[int]) =
+    ## Runs `fn(arg)` on a pool of `asyncBlockingThreads` worker threads and
+    ## completes the returned future with its result on the dispatcher
+    ## thread, so that slow blocking calls such as disk I/O do not stall
+    ## the event loop.
+    ##
+    ## The memory `arg` points to must stay valid until the future completes.
+    ##
+    ## **Note**: Only available with `--threads:on`.
+    runnableExamples:
+      import std/os
+      proc slowSquare(arg: pointer): int {.nimcall, gcsafe.} =
+        sleep(10)
+        let x = cast[ptr int](arg)[]
+        result = x * x
+      var x = 7
+      assert waitFor(runBlocking(slowSquare, addr x)) == 49
+
+    var retFuture = newFuture[int]("runBlocking")
+    if blockingPool == nil:
+      blockingPool = createShared(BlockingPool)
+      initLock(blockingPool.lock)
+      initCond(blockingPool.cond)
+      blockingPool.event = newAsyncEvent()
+      for i in 0 ..< asyncBlockingThreads:
+        createThread(blockingPool.workers[i], blockingWorker, blockingPool)
+    if not blockingEventRegistered:
+      addEvent(blockingPool.event, completeBlockingJobs)
+      blockingEventRegistered = true
+
+    inc blockingJobId
+    blockingJobs[blockingJobId] = retFuture
+    let job = createShared(BlockingJob)
+    job.fn = fn
+    job.arg = arg
+    job.id = blockingJobId
+
+    acquire(blockingPool.lock)
+    if blockingPool.tail == nil:
+      blockingPool.head = job
+    else:
+      blockingPool.tail.next = job
+    blockingPool.tail = job
+    release(blockingPool.lock)
+    signal(blockingPool.cond)
+    return retFuture
+
 proc drain*(timeout = 500) =
   ## Waits for completion of **all** events and processes them. Raises `ValueError`
   ## if there are no pending operations. In contrast to `poll` this
@@ -1922,10 +2133,10 @@ proc sleepAsync*(ms: int | float): owned(Future[void]) =
   var retFuture = newFuture[void]("sleepAsync")
   let p = getGlobalDispatcher()
   when ms is int:
-    p.timers.push((getMonoTime() + initDuration(milliseconds = ms), retFuture))
+    p.timers.add(getMonoTime() + initDuration(milliseconds = ms), retFuture)
   elif ms is float:
     let ns = (ms * 1_000_000).int64
-    p.timers.push((getMonoTime() + initDuration(nanoseconds = ns), retFuture))
+    p.timers.add(getMonoTime() + initDuration(nanoseconds = ns), retFuture)
   return retFuture
 
 proc withTimeout*[T](fut: Future[T], timeout: int): owned(Future[bool]) =
@@ -1934,12 +2145,17 @@ proc withTimeout*[T](fut: Future[T], timeout: int): owned(Future[bool]) =
   ##
   ## If `fut` completes first the returned future will hold true,
   ## otherwise, if `timeout` milliseconds has elapsed first, the returned
-  ## future will hold false.
+  ## future will hold false. The timer is cancelled as soon as `fut`
+  ## completes, so it does not linger in the dispatcher until it expires.
 
   var retFuture = newFuture[bool]("asyncdispatch.`withTimeout`")
-  var timeoutFuture = sleepAsync(timeout)
+  var timeoutFuture = newFuture[void]("asyncdispatch.`withTimeout`")
+  let p = getGlobalDispatcher()
+  let timer = p.timers.add(
+    getMonoTime() + initDuration(milliseconds = timeout), timeoutFuture)
   fut.callback =
     proc () =
+      p.timers.cancel(timer)
       if not retFuture.finished:
         if fut.failed:
           retFuture.fail(fut.error)
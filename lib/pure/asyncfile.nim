@@ -37,10 +37,21 @@ when defined(windows) or defined(nimdoc):
 else:
   import std/posix
 
+const useBlockingPool = compileOption("threads") and
+  not (defined(windows) or defined(nimdoc)) and not defined(nimAsyncFileNoThreads)
+  # Regular files are always "ready" to `epoll`/`kqueue`, so their blocking
+  # reads and writes are offloaded to `asyncdispatch.runBlocking` instead.
+
 type
   AsyncFile* = ref object
     fd: AsyncFD
     offset: int64
+    when useBlockingPool:
+      regular: bool # uses the worker threads
+      append: bool  # opened with `O_APPEND`
+      lastAppend: Future[int] # the last write of an `O_APPEND` file
+      pending: int  # operations issued to the worker threads, not finished
+      closing: bool # `close` was called while `pending > 0`
 
 when defined(windows) or defined(nimdoc):
   proc getDesiredAccess(mode: FileMode): int32 =
@@ -83,17 +94,98 @@ proc getFileSize*(f: AsyncFile): int64 =
     if low == INVALID_FILE_SIZE:
       raiseOSError(osLastError())
     result = (high shl 32) or low
+  elif useBlockingPool:
+    var st: Stat
+    if fstat(f.fd.cint, st) == -1:
+      raiseOSError(osLastError())
+    result = st.st_size.int64
   else:
     let curPos = lseek(f.fd.cint, 0, SEEK_CUR)
     result = lseek(f.fd.cint, 0, SEEK_END)
     f.offset = lseek(f.fd.cint, curPos, SEEK_SET)
     assert(f.offset == curPos)
 
+when useBlockingPool:
+  type
+    FileOp = object
+      fd: cint
+      buf: pointer
+      size: int
+      offset: int64
+      append: bool
+
+  proc preadOp(arg: pointer): int {.nimcall, gcsafe.} =
+    # Returns the number of bytes read or the negated error code.
+    let op = cast[ptr FileOp](arg)
+    while true:
+      result = pread(op.fd, op.buf, op.size, op.offset.Off)
+      if result >= 0: return
+      let err = osLastError()
+      if err.int32 != EINTR: return -err.int
+
+  proc pwriteOp(arg: pointer): int {.nimcall, gcsafe.} =
+    # Writes the whole buffer. Returns 0 or the negated error code.
+    let op = cast[ptr FileOp](arg)
+    var written = 0
+    while written < op.size:
+      let data = cast[pointer](cast[int](op.buf) + written)
+      let res =
+        if op.append: write(op.fd, data, op.size - written)
+        else: pwrite(op.fd, data, op.size - written, Off(op.offset + written))
+      if res < 0:
+        let err = osLastError()
+        if err.int32 != EINTR: return -err.int
+      else:
+        written.inc res
+
+  proc runFileOp(f: AsyncFile, fn: BlockingProc, buf: pointer, size: int,
+                 retFuture: Future[int]) =
+    # Runs `fn` at the current file position on a worker thread and completes
+    # `retFuture` with its result. The position is advanced right away, like
+    # on Windows, so that operations issued back to back do not overlap.
+    # Writes to an `O_APPEND` file have no position; they are started one
+    # after the other instead, so that they reach the file in order.
+    let op = createShared(FileOp)
+    op[] = FileOp(fd: f.fd.cint, buf: buf, size: size, offset: f.offset,
+                  append: f.append)
+    let start = f.offset
+    f.offset.inc size
+    inc f.pending
+    proc run() =
+      let opFuture = runBlocking(fn, op)
+      opFuture.callback =
+        proc () =
+          deallocShared(op)
+          let res = opFuture.read()
+          dec f.pending
+          if f.closing and f.pending == 0:
+            # the `close` that was deferred until the last operation is done
+            discard close(f.fd.cint)
+          if res < 0:
+            if f.offset == start + size: f.offset = start
+            retFuture.fail(newOSError(OSErrorCode(-res)))
+          else:
+            if fn == preadOp and f.offset == start + size:
+              # short read at the end of the file
+              f.offset = start + res
+            retFuture.complete(res)
+    if f.append:
+      let previous = f.lastAppend
+      f.lastAppend = retFuture
+      if previous != nil and not previous.finished:
+        previous.addCallback(run)
+        return
+    run()
+
 proc newAsyncFile*(fd: AsyncFD): AsyncFile =
   ## Creates `AsyncFile` with a previously opened file descriptor `fd`.
   new result
   result.fd = fd
   register(fd)
+  when useBlockingPool:
+    var st: Stat
+    result.regular = fstat(fd.cint, st) == 0 and S_ISREG(st.st_mode)
+    result.append = (fcntl(fd.cint, F_GETFL) and O_APPEND) != 0
 
 proc openAsync*(filename: string, mode = fmRead): AsyncFile =
   ## Opens a file specified by the path in `filename` using
@@ -130,6 +222,10 @@ proc readBuffer*(f: AsyncFile, buf: pointer, size: int): Future[int] =
   ##
   ## If the file pointer is past the end of the file then zero is returned
   ## and no bytes are read into `buf`
+  ##
+  ## `buf` must stay valid until the returned future completes: with
+  ## `--threads:on` regular files are read on a worker thread, see
+  ## `asyncdispatch.runBlocking`.
   var retFuture = newFuture[int]("asyncfile.readBuffer")
 
   when defined(windows) or defined(nimdoc):
@@ -180,6 +276,11 @@ proc readBuffer*(f: AsyncFile, buf: pointer, size: int): Future[int] =
         f.offset.inc bytesRead
         retFuture.complete(bytesRead)
   else:
+    when useBlockingPool:
+      if f.regular:
+        runFileOp(f, preadOp, buf, size, retFuture)
+        return retFuture
+
     proc cb(fd: AsyncFD): bool =
       result = true
       let res = read(fd.cint, cast[cstring](buf), size.cint)
@@ -271,6 +372,25 @@ proc read*(f: AsyncFile, size: int): Future[string] =
         f.offset.inc bytesRead
         retFuture.complete($data)
   else:
+    when useBlockingPool:
+      if f.regular:
+        let buffer = allocShared(size)
+        let opFuture = newFuture[int]("asyncfile.read")
+        runFileOp(f, preadOp, buffer, size, opFuture)
+        opFuture.callback =
+          proc () =
+            if opFuture.failed:
+              deallocShared(buffer)
+              retFuture.fail(opFuture.error)
+            else:
+              let res = opFuture.read()
+              var data = newString(res)
+              if res > 0:
+                copyMem(addr data[0], buffer, res)
+              deallocShared(buffer)
+              retFuture.complete(data)
+        return retFuture
+
     var readBuffer = newString(size)
 
     proc cb(fd: AsyncFD): bool =
@@ -299,6 +419,26 @@ proc read*(f: AsyncFile, size: int): Future[string] =
 proc readLine*(f: AsyncFile): Future[string] {.async.} =
   ## Reads a single line from the specified file asynchronously.
   result = ""
+  when useBlockingPool:
+    if f.regular:
+      # Read in chunks and move the file position back to the end of the
+      # line, instead of a round trip to the worker threads per character.
+      while true:
+        let start = f.offset
+        let chunk = await read(f, 4000)
+        var i = 0
+        while i < chunk.len and chunk[i] notin {'\c', '\L'}: inc i
+        result.add chunk[0 ..< i]
+        if i == chunk.len:
+          if chunk.len == 0: return
+          continue
+        if chunk[i] == '\c' and i + 1 == chunk.len:
+          # the line break may continue in the next chunk
+          if (await read(f, 1)) != "\L": f.offset = start + i + 1
+          return
+        if chunk[i] == '\c' and chunk[i + 1] == '\L': inc i
+        f.offset = start + i + 1
+        return
   while true:
     var c = await read(f, 1)
     if c.len == 0:
@@ -339,7 +479,7 @@ proc writeBuffer*(f: AsyncFile, buf: pointer, size: int): Future[void] =
   ## Writes `size` bytes from `buf` to the file specified asynchronously.
   ##
   ## The returned Future will complete once all data has been written to the
-  ## specified file.
+  ## specified file. `buf` must stay valid until then.
   var retFuture = newFuture[void]("asyncfile.writeBuffer")
   when defined(windows) or defined(nimdoc):
     var ol = newCustom()
@@ -379,6 +519,16 @@ proc writeBuffer*(f: AsyncFile, buf: pointer, size: int): Future[void] =
         assert bytesWritten == size.int32
         retFuture.complete()
   else:
+    when useBlockingPool:
+      if f.regular:
+        let opFuture = newFuture[int]("asyncfile.writeBuffer")
+        runFileOp(f, pwriteOp, buf, size, opFuture)
+        opFuture.callback =
+          proc () =
+            if opFuture.failed: retFuture.fail(opFuture.error)
+            else: retFuture.complete()
+        return retFuture
+
     var written = 0
 
     proc cb(fd: AsyncFD): bool =
@@ -454,6 +604,20 @@ proc write*(f: AsyncFile, data: string): Future[void] =
         assert bytesWritten == data.len.int32
         retFuture.complete()
   else:
+    when useBlockingPool:
+      if f.regular:
+        let buffer = allocShared(max(data.len, 1))
+        if data.len > 0:
+          copyMem(buffer, copy.cstring, data.len)
+        let opFuture = newFuture[int]("asyncfile.write")
+        runFileOp(f, pwriteOp, buffer, data.len, opFuture)
+        opFuture.callback =
+          proc () =
+            deallocShared(buffer)
+            if opFuture.failed: retFuture.fail(opFuture.error)
+            else: retFuture.complete()
+        return retFuture
+
     var written = 0
 
     proc cb(fd: AsyncFD): bool =
@@ -503,12 +667,17 @@ proc setFileSize*(f: AsyncFile, length: int64) =
       raiseOSError(osLastError())
 
 proc close*(f: AsyncFile) =
-  ## Closes the file specified.
+  ## Closes the file specified. Reads and writes that are still pending are
+  ## completed first: the file is closed once the last of them is done.
   unregister(f.fd)
   when defined(windows) or defined(nimdoc):
     if not closeHandle(f.fd.Handle).bool:
       raiseOSError(osLastError())
   else:
+    when useBlockingPool:
+      if f.pending > 0:
+        f.closing = true
+        return
     if close(f.fd.cint) == -1:
       raiseOSError(osLastError())
 
@@ -20,8 +20,9 @@ type
   CallbackFunc = proc () {.closure, gcsafe.}
 
   CallbackList = object
-    function: CallbackFunc
-    next: owned(ref CallbackList)
+    function: CallbackFunc    ## The first callback, stored inline as most
+                              ## futures only ever have one.
+    rest: seq[CallbackFunc]   ## Any further callbacks, in the order added.
 
   FutureBase* = ref object of RootObj  ## Untyped future.
     callbacks: CallbackList
@@ -163,35 +164,20 @@ proc checkFinished[T](future: Future[T]) =
       raise err
 
 proc call(callbacks: var CallbackList) =
-  var current = callbacks
-  while true:
-    if not current.function.isNil:
-      callSoon(current.function)
-
-    if current.next.isNil:
-      break
-    else:
-      current = current.next[]
-  # callback will be called only once, let GC collect them now
-  callbacks.next = nil
-  callbacks.function = nil
+  # callbacks will be called only once, let GC collect them now
+  let first = move callbacks.function
+  let rest = move callbacks.rest
+  if not first.isNil:
+    callSoon(first)
+  for function in rest:
+    callSoon(function)
 
 proc add(callbacks: var CallbackList, function: CallbackFunc) =
   if callbacks.function.isNil:
     callbacks.function = function
-    assert callbacks.next == nil
+    assert callbacks.rest.len == 0
   else:
-    let newCallback = new(ref CallbackList)
-    newCallback.function = function
-    newCallback.next = nil
-
-    if callbacks.next == nil:
-      callbacks.next = newCallback
-    else:
-      var last = callbacks.next
-      while last.next != nil:
-        last = last.next
-      last.next = newCallback
+    callbacks.rest.add function
 
 proc completeImpl[T, U](future: Future[T], val: sink U, isVoid: static bool) =
   #assert(not future.finished, "Future already finished, cannot finish twice.")
@@ -244,7 +230,7 @@ proc fail*[T](future: Future[T], error: ref Exception) =
 
 proc clearCallbacks*(future: FutureBase) =
   future.callbacks.function = nil
-  future.callbacks.next = nil
+  future.callbacks.rest.setLen(0)
 
 proc addCallback*(future: FutureBase, cb: proc() {.closure, gcsafe.}) =
   ## Adds the callbacks proc to be called when the future completes.
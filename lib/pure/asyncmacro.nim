@@ -15,6 +15,7 @@ type
   Context = ref object
     inTry: int
     hasRet: bool
+    exitLabel: NimNode # leaves the body of a proc without `await`
 
 # TODO: Ref https://github.com/nim-lang/Nim/issues/5617
 # TODO: Add more line infos
@@ -92,7 +93,10 @@ proc processBody(ctx: Context; node, needsCompletionSym, retFutureSym: NimNode,
         result.add newAssignment(newIdentNode("result"), x)
         result.add newAssignment(needsCompletionSym, newLit(true))
 
-    result.add newNimNode(nnkReturnStmt, node).add(newNilLit())
+    if ctx.exitLabel != nil:
+      result.add newNimNode(nnkBreakStmt, node).add(ctx.exitLabel)
+    else:
+      result.add newNimNode(nnkReturnStmt, node).add(newNilLit())
     return # Don't process the children of this return stmt
   of RoutineNodes-{nnkTemplateDef}:
     # skip all the nested procedure definitions
@@ -127,6 +131,18 @@ proc processBody(ctx: Context; node, needsCompletionSym, retFutureSym: NimNode,
 
   # echo result.repr
 
+proc hasAwait(node: NimNode): bool =
+  ## Whether `node` can suspend: it contains `await` or `yield` outside of
+  ## nested routines. Templates are included, they expand into the body.
+  case node.kind
+  of nnkIdent, nnkSym: result = node.eqIdent("await")
+  of nnkYieldStmt: result = true
+  of RoutineNodes-{nnkTemplateDef}: result = false
+  else:
+    result = false
+    for child in node:
+      if hasAwait(child): return true
+
 proc getName(node: NimNode): string =
   case node.kind
   of nnkPostfix:
@@ -248,23 +264,23 @@ proc asyncSingleProc(prc: NimNode): NimNode =
   # ->   <proc_body>
   # ->   complete(retFuture, result)
   var iteratorNameSym = genSym(nskIterator, $prcName & " (Async)")
-  var needsCompletionSym = genSym(nskVar, "needsCompletion")
-  var ctx = Context()
-  var procBody = processBody(ctx, prc.body, needsCompletionSym, retFutureSym, futureVarIdents)
-  # don't do anything with forward bodies (empty)
-  if procBody.kind != nnkEmpty:
+  proc transformBody(body: NimNode; ctx: Context; retFutureSym: NimNode): NimNode =
+    let needsCompletionSym = genSym(nskVar, "needsCompletion")
+    result = processBody(ctx, body, needsCompletionSym, retFutureSym, futureVarIdents)
+    # don't do anything with forward bodies (empty)
+    if result.kind == nnkEmpty: return
     # fix #13899, defer should not escape its original scope
-    let blockStmt = newStmtList(newTree(nnkBlockStmt, newEmptyNode(), procBody))
-    procBody = newStmtList()
+    let blockStmt = newStmtList(newTree(nnkBlockStmt, newEmptyNode(), result))
+    result = newStmtList()
     let resultIdent = ident"result"
-    procBody.add quote do:
+    result.add quote do:
       # Check whether there is an implicit return
       when typeof(`blockStmt`) is void:
         `blockStmt`
       else:
         `resultIdent` = `blockStmt`
-    procBody.add(createFutureVarCompletions(futureVarIdents, nil))
-    procBody.insert(0): quote do:
+    result.add(createFutureVarCompletions(futureVarIdents, nil))
+    result.insert(0): quote do:
       {.push warning[resultshadowed]: off.}
       when `subRetType` isnot void:
         var `resultIdent`: `subRetType`
@@ -273,9 +289,60 @@ proc asyncSingleProc(prc: NimNode): NimNode =
       {.pop.}
 
       var `needsCompletionSym` = false
-    procBody.add quote do:
+    result.add quote do:
       complete(`retFutureSym`, `resultIdent`)
 
+  # A body without `await` runs to its end in one go, so it does not need a
+  # closure iterator: it becomes a nested proc that gets the future and the
+  # parameters as arguments. That leaves the future as the only allocation
+  # of a call, instead of the future and the environments of the proc and of
+  # the iterator. The proc is named like the iterator, so tracebacks stay
+  # the same. An `await` hidden in a template makes it fail to compile, the
+  # closure iterator is used then.
+  proc syncVersion(): NimNode =
+    let futureSym = genSym(nskParam, "retFuture")
+    let exitLabel = genSym(nskLabel, "asyncBody")
+    let body = transformBody(pristineBody.copyNimTree, Context(exitLabel: exitLabel), futureSym)
+    let name = genSym(nskProc, $prcName & " (Async)")
+    let futureVarCompletions = createFutureVarCompletions(futureVarIdents, nil)
+    var params = @[newEmptyNode(), newIdentDefs(futureSym,
+      nnkBracketExpr.newTree(ident"Future", subRetType))]
+    var call = newCall(name, retFutureSym)
+    for i in 1 ..< prc.params.len:
+      let defs = prc.params[i]
+      for j in 0 ..< defs.len - 2:
+        let typ = if defs[^2].kind != nnkEmpty: defs[^2].copyNimTree
+                  else: newCall(ident"typeof", defs[^1].copyNimTree)
+        params.add newIdentDefs(defs[j].copyNimTree, typ)
+        call.add(if defs[j].kind == nnkPragmaExpr: defs[j][0].copyNimTree
+                 else: defs[j].copyNimTree)
+    let syncProc = newProc(name, params, quote do:
+      try:
+        block `exitLabel`:
+          `body`
+      except:
+        `futureVarCompletions`
+        if `futureSym`.finished: raise
+        else: `futureSym`.fail(getCurrentException()))
+    if prc.pragma.findChild(it.kind in {nnkSym, nnkIdent} and $it == "gcsafe") != nil:
+      syncProc.addPragma(newIdentNode("gcsafe"))
+    result = newStmtList(syncProc, call)
+
+  # `transformBody` changes the body in place
+  let pristineBody = prc.body.copyNimTree
+  var canRunSync = prc.body.kind != nnkEmpty and not hasAwait(prc.body)
+  for i in 1 ..< prc.params.len:
+    # parameters that can't be passed on as they are
+    let typ = prc.params[i][^2]
+    if typ.eqIdent("typedesc") or typ.eqIdent("untyped") or
+        typ.eqIdent("typed") or typ.kind in {nnkBracketExpr, nnkCall, nnkCommand} and
+        typ[0].eqIdent("typedesc") or typ.kind == nnkStaticTy or
+        typ.kind in {nnkBracketExpr, nnkCall, nnkCommand} and typ[0].eqIdent("static"):
+      canRunSync = false
+
+  var ctx = Context()
+  var procBody = transformBody(prc.body, ctx, retFutureSym)
+  if procBody.kind != nnkEmpty:
     var closureIterator = newProc(iteratorNameSym, [quote do: owned(FutureBase)],
                                   procBody, nnkIteratorDef)
     closureIterator.pragma = newNimNode(nnkPragma, lineInfoFrom = prc.body)
@@ -284,7 +351,7 @@ proc asyncSingleProc(prc: NimNode): NimNode =
     # If proc has an explicit gcsafe pragma, we add it to iterator as well.
     if prc.pragma.findChild(it.kind in {nnkSym, nnkIdent} and $it == "gcsafe") != nil:
       closureIterator.addPragma(newIdentNode("gcsafe"))
-    outerProcBody.add(closureIterator)
+    var asyncPart = newStmtList(closureIterator)
 
     # -> createCb(retFuture)
     # NOTE: The NimAsyncContinueSuffix is checked for in asyncfutures.nim to produce
@@ -295,7 +362,18 @@ proc asyncSingleProc(prc: NimNode): NimNode =
                           cbName,
                           createFutureVarCompletions(futureVarIdents, nil)
                         )
-    outerProcBody.add procCb
+    asyncPart.add procCb
+
+    if canRunSync:
+      let syncCheck = syncVersion()
+      let syncPart = syncVersion()
+      outerProcBody.add quote do:
+        when compiles(block: `syncCheck`):
+          `syncPart`
+        else:
+          `asyncPart`
+    else:
+      outerProcBody.add asyncPart
 
     # -> return retFuture
     outerProcBody.add newNimNode(nnkReturnStmt, prc.body[^1]).add(retFutureSym)
@@ -122,6 +122,10 @@ type
     buffer: array[0..BufferSize, char]
     currPos: int     # current index in buffer
     bufLen: int      # current length of buffer
+    writeHighWater: int # flush threshold of `writeBuf`, 0 if writes are unbuffered
+    writeBuf: string    # data accepted by `send` but not written yet
+    writer: Future[void] # writes out `writeBuf`, nil when idle
+    flushScheduled: bool # an end-of-tick flush is pending
     isSsl: bool
     when defineSsl:
       sslHandle: SslPtr
@@ -440,13 +444,81 @@ proc recv*(socket: AsyncSocket, size: int,
     let read = readInto(addr result[0], size, socket, flags)
     result.setLen(read)
 
+template sendUnbuffered(socket: AsyncSocket, data: string,
+                         flags: set[SocketFlag]) =
+  if socket.isSsl:
+    when defineSsl:
+      var copy = data
+      sslLoop(socket, flags,
+        sslWrite(socket.sslHandle, cast[cstring](addr copy[0]), copy.len.cint))
+      await sendPendingSslData(socket, flags)
+  else:
+    await send(socket.fd.AsyncFD, data, flags)
+
+proc writeBuffered(socket: AsyncSocket, flags: set[SocketFlag]) {.async.} =
+  # Writes out the write buffer, including data that is added to it while
+  # earlier data is being sent. There is at most one such writer per socket.
+  while socket.writeBuf.len > 0 and not socket.closed:
+    let data = move socket.writeBuf
+    sendUnbuffered(socket, data, flags)
+
+proc startWriter(socket: AsyncSocket, flags: set[SocketFlag]): Future[void] =
+  if socket.writer == nil or socket.writer.finished:
+    socket.writer = writeBuffered(socket, flags)
+  result = socket.writer
+
+proc checkWriteError(socket: AsyncSocket) =
+  # Reraises the error of a write buffer flush nobody waited for.
+  if socket.writer != nil and socket.writer.failed:
+    let error = socket.writer.error
+    socket.writer = nil
+    raise error
+
+proc flush*(socket: AsyncSocket,
+            flags = {SocketFlag.SafeDisconn}) {.async, since: (2, 3).} =
+  ## Writes out all data that `send` has buffered on `socket`. The returned
+  ## future will complete once all of it has been sent.
+  ##
+  ## Raises the error of an earlier automatic flush that failed. Does nothing
+  ## for sockets without a write buffer, see `setWriteBuffer`.
+  assert socket != nil
+  socket.checkWriteError()
+  if socket.writeBuf.len > 0 or
+      (socket.writer != nil and not socket.writer.finished):
+    await socket.startWriter(flags)
+
+proc scheduleFlush(socket: AsyncSocket, flags: set[SocketFlag]): bool =
+  # Sends issued during the same tick of the dispatcher are written out
+  # together by a single end-of-tick flush. Returns `true` if the caller
+  # has to flush right away because the buffer reached its high-water mark.
+  if socket.writeBuf.len >= socket.writeHighWater:
+    return true
+  if not socket.flushScheduled:
+    socket.flushScheduled = true
+    callSoon(proc () =
+      socket.flushScheduled = false
+      if not socket.closed and socket.writeBuf.len > 0:
+        discard socket.startWriter(flags)
+    )
+
 proc send*(socket: AsyncSocket, buf: pointer, size: int,
             flags = {SocketFlag.SafeDisconn}) {.async.} =
   ## Sends `size` bytes from `buf` to `socket`. The returned future will complete once all
   ## data has been sent.
+  ##
+  ## If `socket` has a write buffer, the data is copied into it and the
+  ## returned future completes once it has been buffered.
   assert socket != nil
   assert(not socket.closed, "Cannot `send` on a closed socket")
-  if socket.isSsl:
+  if socket.writeHighWater > 0:
+    socket.checkWriteError()
+    let pos = socket.writeBuf.len
+    socket.writeBuf.setLen(pos + size)
+    if size > 0:
+      copyMem(addr socket.writeBuf[pos], buf, size)
+    if scheduleFlush(socket, flags):
+      await socket.flush(flags)
+  elif socket.isSsl:
     when defineSsl:
       sslLoop(socket, flags,
               sslWrite(socket.sslHandle, cast[cstring](buf), size.cint))
@@ -458,15 +530,42 @@ proc send*(socket: AsyncSocket, data: string,
            flags = {SocketFlag.SafeDisconn}) {.async.} =
   ## Sends `data` to `socket`. The returned future will complete once all
   ## data has been sent.
+  ##
+  ## If `socket` has a write buffer, the returned future completes once
+  ## `data` has been buffered, see `setWriteBuffer`.
   assert socket != nil
-  if socket.isSsl:
-    when defineSsl:
-      var copy = data
-      sslLoop(socket, flags,
-        sslWrite(socket.sslHandle, cast[cstring](addr copy[0]), copy.len.cint))
-      await sendPendingSslData(socket, flags)
+  if socket.writeHighWater > 0:
+    socket.checkWriteError()
+    socket.writeBuf.add data
+    if scheduleFlush(socket, flags):
+      await socket.flush(flags)
   else:
-    await send(socket.fd.AsyncFD, data, flags)
+    sendUnbuffered(socket, data, flags)
+
+proc setWriteBuffer*(socket: AsyncSocket,
+                     highWaterMark = 64 * 1024) {.since: (2, 3).} =
+  ## Enables write buffering on `socket`; a `highWaterMark` of 0 disables it
+  ## again.
+  ##
+  ## With a write buffer, `send` only copies the data into the buffer. All
+  ## data sent during the same tick of the dispatcher is coalesced into a
+  ## single write at the end of the tick, and `send` waits for the buffer
+  ## to be written out whenever it holds `highWaterMark` bytes or more. This
+  ## saves syscalls and packets for protocols that write many small frames.
+  ##
+  ## Errors of these automatic writes are raised by the next `send` or
+  ## `flush`. Call `flush` to wait until all buffered data has been sent,
+  ## for example before `close` or before disabling the write buffer.
+  runnableExamples("-r:off"):
+    import std/asyncdispatch
+    proc pipeline(socket: AsyncSocket, keys: seq[string]) {.async.} =
+      socket.setWriteBuffer()
+      for key in keys:
+        await socket.send("GET " & key & "\r\n")
+      await socket.flush()
+  assert socket != nil
+  assert highWaterMark >= 0
+  socket.writeHighWater = highWaterMark
 
 proc acceptAddr*(socket: AsyncSocket, flags = {SocketFlag.SafeDisconn},
                  inheritable = defined(nimInheritHandles)):
@@ -858,8 +858,10 @@ iterator mpairs*(node: var JsonNode): tuple[key: string, val: var JsonNode] =
   for key, val in mpairs(node.fields):
     yield (key, val)
 
-proc parseJson(p: var JsonParser; rawIntegers, rawFloats: bool, depth = 0): JsonNode =
-  ## Parses JSON from a JSON Parser `p`.
+proc parseJson*(p: var JsonParser; rawIntegers, rawFloats: bool, depth = 0): JsonNode =
+  ## Parses the JSON value starting at the current token of `p` and leaves
+  ## `p` at the token that follows it. `depth` is the nesting level of the
+  ## value; it is used to enforce the nesting limit.
   case p.tok
   of tkString:
     # we capture 'p.a' here, so we need to give it a fresh buffer afterwards:
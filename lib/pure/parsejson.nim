@@ -11,7 +11,7 @@
 ## and exported by the `json` standard library
 ## module, but can also be used in its own right.
 
-import std/[strutils, lexbase, streams, unicode]
+import std/[strutils, lexbase, streams, unicode, bitops]
 import std/private/decode_helpers
 
 when defined(nimPreviewSlimSystem):
@@ -175,6 +175,52 @@ proc parseEscapedUTF16*(buf: cstring, pos: var int): int =
     else:
       return -1
 
+const wordScan = not defined(js) and not defined(nimscript)
+
+when wordScan:
+  from std/private/swar import zeroBytes
+
+proc skipPlain(buf: string, pos: int): int {.inline.} =
+  ## returns the position of the first char in `{'"', '\\', '\c', '\L', '\0'}`
+  ## at or after `pos`. The buffer always contains one of these before its
+  ## end (the sentinel is a newline or `'\0'`), so 8 bytes are checked at a
+  ## time and only the tail is scanned char by char.
+  result = pos
+  when wordScan:
+    when nimvm: discard
+    else:
+      const ones = 0x0101010101010101'u64
+      while result + 8 <= buf.len:
+        var x: uint64
+        copyMem(addr x, addr buf[result], 8)
+        let m = zeroBytes(x xor (ones * uint64('"'))) or
+                zeroBytes(x xor (ones * uint64('\\'))) or
+                zeroBytes(x xor (ones * uint64('\c'))) or
+                zeroBytes(x xor (ones * uint64('\L'))) or
+                zeroBytes(x)
+        if m != 0:
+          when cpuEndian == littleEndian:
+            return result + countTrailingZeroBits(m) shr 3
+          else:
+            return result + countLeadingZeroBits(m) shr 3
+        inc(result, 8)
+  while buf[result] notin {'"', '\\', '\c', '\L', '\0'}:
+    inc(result)
+
+proc addChars(s: var string, buf: string, first, last: int) {.inline.} =
+  ## appends `buf[first ..< last]` to `s`.
+  let n = last - first
+  if n <= 0: return
+  let L = s.len
+  s.setLen(L + n)
+  when wordScan:
+    when nimvm:
+      for i in 0 ..< n: s[L + i] = buf[first + i]
+    else:
+      copyMem(addr s[L], addr buf[first], n)
+  else:
+    for i in 0 ..< n: s[L + i] = buf[first + i]
+
 proc parseString(my: var JsonParser): TokKind =
   result = tkString
   var pos = my.bufpos + 1
@@ -258,8 +304,10 @@ proc parseString(my: var JsonParser): TokKind =
       pos = lexbase.handleLF(my, pos)
       add(my.a, '\L')
     else:
-      add(my.a, my.buf[pos])
-      inc(pos)
+      # copy the whole run of plain characters at once
+      let last = skipPlain(my.buf, pos + 1)
+      addChars(my.a, my.buf, pos, last)
+      pos = last
   my.bufpos = pos # store back
 
 proc skip(my: var JsonParser) =
@@ -313,34 +361,37 @@ proc skip(my: var JsonParser) =
       break
   my.bufpos = pos
 
-proc parseNumber(my: var JsonParser) =
+proc parseNumber(my: var JsonParser): bool =
+  ## scans a number into `my.a`; returns true if it is a float.
   var pos = my.bufpos
+  var first = pos
+  result = false
   if my.buf[pos] == '-':
-    add(my.a, '-')
     inc(pos)
   if my.buf[pos] == '.':
+    # a leading dot is read as "0."
+    addChars(my.a, my.buf, first, pos)
     add(my.a, "0.")
     inc(pos)
+    first = pos
+    result = true
   else:
     while my.buf[pos] in Digits:
-      add(my.a, my.buf[pos])
       inc(pos)
     if my.buf[pos] == '.':
-      add(my.a, '.')
       inc(pos)
+      result = true
   # digits after the dot:
   while my.buf[pos] in Digits:
-    add(my.a, my.buf[pos])
     inc(pos)
   if my.buf[pos] in {'E', 'e'}:
-    add(my.a, my.buf[pos])
     inc(pos)
+    result = true
     if my.buf[pos] in {'+', '-'}:
-      add(my.a, my.buf[pos])
       inc(pos)
     while my.buf[pos] in Digits:
-      add(my.a, my.buf[pos])
       inc(pos)
+  addChars(my.a, my.buf, first, pos)
   my.bufpos = pos
 
 proc parseName(my: var JsonParser) =
@@ -356,8 +407,7 @@ proc getTok*(my: var JsonParser): TokKind =
   skip(my) # skip whitespace, comments
   case my.buf[my.bufpos]
   of '-', '.', '0'..'9':
-    parseNumber(my)
-    if {'.', 'e', 'E'} in my.a:
+    if parseNumber(my):
       result = tkFloat
     else:
       result = tkInt
@@ -73,6 +73,7 @@ runnableExamples:
 import std/parseutils
 from std/math import pow, floor, log10
 from std/algorithm import fill, reverse
+from std/bitops import countTrailingZeroBits, countLeadingZeroBits
 import std/enumutils
 
 from std/unicode import toLower, toUpper
@@ -384,6 +385,82 @@ template stringHasSep(s: string, index: int, sep: char): bool =
 template stringHasSep(s: string, index: int, sep: string): bool =
   s.substrEq(index, sep)
 
+when not (defined(js) or defined(nimdoc) or defined(nimscript)):
+  func c_memchr(cstr: pointer, c: char, n: csize_t): pointer {.
+                importc: "memchr", header: "<string.h>".}
+  const hasCStringBuiltin = true
+else:
+  const hasCStringBuiltin = false
+
+when hasCStringBuiltin:
+  from std/private/swar import zeroBytes
+
+  func findFewChars(s: string, chars: set[char], start, last: int): int =
+    # Searches for up to three different characters 8 bytes at a time.
+    # `chars` must not contain more.
+    const ones = 0x0101010101010101'u64
+    var pattern: array[3, uint64]
+    var n = 0
+    when cpuEndian == littleEndian:
+      let words = cast[array[4, uint64]](chars)
+      for w in 0 ..< words.len:
+        var bits = words[w]
+        while bits != 0:
+          pattern[n] = ones * uint64(w * 64 + countTrailingZeroBits(bits))
+          inc n
+          bits = bits and (bits - 1)
+    else:
+      for c in chars:
+        pattern[n] = ones * uint64(c)
+        inc n
+    if n == 0: return -1
+    for k in n ..< pattern.len: pattern[k] = pattern[0]
+    var i = start
+    while i + 7 <= last:
+      var x: uint64
+      copyMem(addr x, unsafeAddr s[i], 8)
+      let m = zeroBytes(x xor pattern[0]) or zeroBytes(x xor pattern[1]) or
+              zeroBytes(x xor pattern[2])
+      if m != 0:
+        when cpuEndian == littleEndian:
+          return i + countTrailingZeroBits(m) shr 3
+        else:
+          return i + countLeadingZeroBits(m) shr 3
+      inc(i, 8)
+    for j in i..last:
+      if s[j] in chars: return j
+    result = -1
+
+  proc addChars(s: var string, src: string, first, last: int) {.inline.} =
+    # appends `src[first ..< last]` to `s`
+    let n = last - first
+    if n <= 0: return
+    let L = s.len
+    s.setLen(L + n)
+    copyMem(addr s[L], unsafeAddr src[first], n)
+
+func skipToSep(s: string, sep: char, start: int): int {.inline.} =
+  # the position of the next `sep` at or after `start`, or `s.len`
+  when nimvm: discard
+  else:
+    when hasCStringBuiltin:
+      if start < s.len:
+        let found = c_memchr(s[start].unsafeAddr, sep, cast[csize_t](s.len - start))
+        return if found.isNil: s.len else: cast[int](found) -% cast[int](s.cstring)
+  result = start
+  while result < s.len and s[result] != sep: inc(result)
+
+func skipToSep(s: string, seps: set[char], start: int): int {.inline.} =
+  # the position of the next char in `seps` at or after `start`, or `s.len`
+  when nimvm: discard
+  else:
+    when hasCStringBuiltin:
+      if s.len - start >= 16 and card(seps) <= 3:
+        result = findFewChars(s, seps, start, s.high)
+        return if result < 0: s.len else: result
+  result = start
+  while result < s.len and s[result] notin seps: inc(result)
+
 template splitCommon(s, sep, maxsplit, sepLen) =
   ## Common code for split procs
   var last = 0
@@ -391,8 +468,11 @@ template splitCommon(s, sep, maxsplit, sepLen) =
 
   while last <= len(s):
     var first = last
-    while last < len(s) and not stringHasSep(s, last, sep):
-      inc(last)
+    when sep is char or sep is set[char]:
+      last = skipToSep(s, sep, last)
+    else:
+      while last < len(s) and not stringHasSep(s, last, sep):
+        inc(last)
     if splits == 0: last = len(s)
     yield substr(s, first, last-1)
     if splits == 0: break
@@ -1946,13 +2026,6 @@ func find*(a: SkipTable, s, sub: string, start: Natural = 0, last = -1): int {.
       dec i
     inc skip, a[s[skip + subLast]]
 
-when not (defined(js) or defined(nimdoc) or defined(nimscript)):
-  func c_memchr(cstr: pointer, c: char, n: csize_t): pointer {.
-                importc: "memchr", header: "<string.h>".}
-  const hasCStringBuiltin = true
-else:
-  const hasCStringBuiltin = false
-
 func find*(s: string, sub: char, start: Natural = 0, last = -1): int {.rtl,
     extern: "nsuFindChar".} =
   ## Searches for `sub` in `s` inside range `start..last` (both ends included).
@@ -1999,6 +2072,12 @@ func find*(s: string, chars: set[char], start: Natural = 0, last = -1): int {.
   ## * `multiReplace func<#multiReplace,string,varargs[]>`_
   result = -1
   let last = if last < 0: s.high else: last
+  when nimvm: discard
+  else:
+    when hasCStringBuiltin:
+      # past the end, the loop below raises the IndexDefect
+      if last - int(start) >= 16 and last <= s.high and card(chars) <= 3:
+        return findFewChars(s, chars, start, last)
   for i in int(start)..last:
     if s[i] in chars:
       return i
@@ -2033,15 +2112,34 @@ func find*(s, sub: string, start: Natural = 0, last = -1): int {.rtl,
     useSkipTable()
   else:
     when declared(memmem):
+      let last = if last < 0: s.high else: min(last, s.high)
       let subLen = sub.len
-      if last < 0 and start < s.len and subLen != 0:
-        let found = memmem(s[start].unsafeAddr, csize_t(s.len - start), sub.cstring, csize_t(subLen))
+      if start <= last and subLen != 0:
+        let found = memmem(s[start].unsafeAddr, csize_t(last - start + 1), sub.cstring, csize_t(subLen))
         result = if not found.isNil:
             cast[int](found) -% cast[int](s.cstring)
           else:
             -1
       else:
         useSkipTable()
+    elif hasCStringBuiltin:
+      # Without `memmem`, let `memchr` find the candidates for the first
+      # character and check the last character before the rest. This needs
+      # no table, which `useSkipTable` would have to build on every call.
+      let last = if last < 0: s.high else: min(last, s.high)
+      let subLast = sub.len - 1
+      if subLast < 0:
+        useSkipTable()
+      else:
+        result = -1
+        var i = int(start)
+        while i + subLast <= last:
+          i = find(s, sub[0], i, last - subLast)
+          if i < 0: break
+          if s[i + subLast] == sub[subLast] and
+              equalMem(unsafeAddr s[i + 1], unsafeAddr sub[1], subLast - 1):
+            return i
+          inc i
     else:
       useSkipTable()
 
@@ -2316,6 +2414,15 @@ func multiReplace*(s: string, replacements: varargs[(string, string)]): string =
   while i < s.len:
     block sIteration:
       # Assume most chars in s are not candidates for any replacement operation
+      # and copy the runs between candidates at once
+      when nimvm: discard
+      else:
+        when hasCStringBuiltin:
+          var j = find(s, fastChk, i)
+          if j < 0: j = s.len
+          addChars(result, s, i, j)
+          i = j
+          if i == s.len: break sIteration
       if s[i] in fastChk:
         for sub, by in replacements.items:
           if sub.len > 0 and s.continuesWith(sub, i):
@@ -2329,6 +2436,143 @@ func multiReplace*(s: string, replacements: varargs[(string, string)]): string =
 
 
 
+type
+  MultiSearcher* = object
+    ## A set of patterns prepared for searching all of them in a single pass
+    ## over the input. It is an Aho-Corasick automaton whose transitions are
+    ## stored for classes of characters that occur in the same patterns.
+    classes: array[char, int32] # class of every char, 0 for unused chars
+    classCount: int
+    delta: seq[int32]           # `classCount` transitions per state
+    terminal: seq[int32]        # the first pattern that ends in a state, or -1
+    output: seq[int32]          # next state on the suffix chain that ends a pattern, or -1
+    nextSame: seq[int32]        # next pattern equal to a pattern, or -1
+    lens: seq[int]
+    firstChars: set[char]
+
+func initMultiSearcher*(patterns: openArray[string]): MultiSearcher {.since: (2, 3).} =
+  ## Prepares a `MultiSearcher` for `patterns`. Empty patterns never match.
+  ##
+  ## See also:
+  ## * `findAll iterator<#findAll.i,MultiSearcher,string,int>`_
+  ## * `find func<#find,MultiSearcher,string,int>`_
+  runnableExamples:
+    let m = initMultiSearcher(["he", "she", "his", "hers"])
+    assert m in "ushers"
+    assert m.find("ushers") == (pattern: 1, first: 1)
+  result.classCount = 1
+  for p in patterns:
+    for c in p:
+      if result.classes[c] == 0:
+        result.classes[c] = int32(result.classCount)
+        inc result.classCount
+  let k = result.classCount
+
+  template addState(): int32 =
+    let old = result.delta.len
+    result.delta.setLen(old + k)
+    for j in old ..< old + k: result.delta[j] = -1
+    result.terminal.add -1
+    int32(result.terminal.len - 1)
+
+  discard addState() # the root
+  result.lens = newSeq[int](patterns.len)
+  result.nextSame = newSeq[int32](patterns.len)
+  for i, p in patterns:
+    result.lens[i] = p.len
+    result.nextSame[i] = -1
+    if p.len == 0: continue
+    result.firstChars.incl p[0]
+    var state = 0
+    for c in p:
+      let slot = state * k + result.classes[c]
+      if result.delta[slot] < 0:
+        let next = addState()
+        result.delta[slot] = next
+      state = result.delta[slot]
+    if result.terminal[state] < 0:
+      result.terminal[state] = int32(i)
+    else:
+      var q = result.terminal[state]
+      while result.nextSame[q] >= 0: q = result.nextSame[q]
+      result.nextSame[q] = int32(i)
+
+  # Breadth first, turn the trie into a complete automaton: a missing
+  # transition is the one of the longest proper suffix that is in the trie.
+  let states = result.terminal.len
+  var fail = newSeq[int32](states)
+  var queue = newSeqOfCap[int32](states)
+  result.output = newSeq[int32](states)
+  result.output[0] = -1
+  for c in 0 ..< k:
+    let v = result.delta[c]
+    if v < 0:
+      result.delta[c] = 0
+    else:
+      result.output[v] = -1
+      queue.add v
+  var head = 0
+  while head < queue.len:
+    let u = int(queue[head])
+    inc head
+    for c in 0 ..< k:
+      let v = result.delta[u * k + c]
+      let f = result.delta[int(fail[u]) * k + c]
+      if v < 0:
+        result.delta[u * k + c] = f
+      else:
+        fail[v] = f
+        result.output[v] = if result.terminal[f] >= 0: f else: result.output[f]
+        queue.add v
+
+iterator findAll*(m: MultiSearcher, s: string, start = 0): tuple[pattern, first: int] {.
+    since: (2, 3).} =
+  ## Yields every occurrence of the patterns of `m` in `s[start..^1]`,
+  ## overlapping ones included, as the index of the pattern and the position
+  ## of its first character. Occurrences are yielded in the order in which
+  ## they end; of those that end at the same position, longer ones come first.
+  runnableExamples:
+    var found: seq[(int, int)]
+    for x in initMultiSearcher(["he", "she", "his", "hers"]).findAll("ushers"):
+      found.add x
+    assert found == @[(1, 1), (0, 2), (3, 2)]
+  var state = 0
+  var i = start
+  while i < s.len:
+    if state == 0:
+      # only the first character of a pattern can leave the root
+      i = find(s, m.firstChars, i)
+      if i < 0: break
+    state = m.delta[state * m.classCount + m.classes[s[i]]]
+    var t = if m.terminal[state] >= 0: int32(state) else: m.output[state]
+    while t >= 0:
+      var p = m.terminal[t]
+      while p >= 0:
+        yield (int(p), i - m.lens[p] + 1)
+        p = m.nextSame[p]
+      t = m.output[t]
+    inc i
+
+func find*(m: MultiSearcher, s: string, start = 0): tuple[pattern, first: int] {.
+    since: (2, 3).} =
+  ## Returns the occurrence of a pattern of `m` in `s[start..^1]` that ends
+  ## first, or `(-1, -1)` if there is none.
+  ##
+  ## See also:
+  ## * `findAll iterator<#findAll.i,MultiSearcher,string,int>`_
+  runnableExamples:
+    let m = initMultiSearcher(["cd", "abcde"])
+    assert m.find("abcdef") == (pattern: 0, first: 2)
+    assert m.find("abc") == (pattern: -1, first: -1)
+  for x in findAll(m, s, start):
+    return x
+  result = (-1, -1)
+
+func contains*(s: string, m: MultiSearcher): bool {.since: (2, 3).} =
+  ## Returns true if a pattern of `m` occurs in `s`, which can also be
+  ## written as `m in s`.
+  find(m, s).pattern >= 0
+
 func insertSep*(s: string, sep = '_', digits = 3): string {.rtl,
     extern: "nsuInsertSep".} =
   ## Inserts the separator `sep` after `digits` characters (default: 3)
@@ -0,0 +1,339 @@
+#
+#
+#            Nim's Runtime Library
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## The `flattables` module implements `FlatTable`, a hash table in the style
+## of Swiss tables: next to the array of `(key, value)` entries the table
+## keeps one control byte per slot, which is either "empty" or 7 bits of the
+## hash of the key stored there. Lookups compare the control bytes of 8 slots
+## at once, so a probe only touches an entry when its hash bits already
+## match, and a miss usually costs a single load of control bytes. Every
+## entry also keeps the full hash of its key, so growing the table and
+## deleting never call `hash` again.
+##
+## Deletion shifts the following entries back instead of leaving tombstones,
+## so lookups never slow down in tables that see many deletions.
+##
+## Like `Table`, a `FlatTable` has value semantics. The iteration order is
+## unspecified.
+runnableExamples:
+  var t = {"one": 1, "two": 2}.toFlatTable
+  t["three"] = 3
+  assert t["two"] == 2
+  assert "four" notin t
+  t.del("one")
+  assert t.len == 2
+  assert t.getOrDefault("one", -1) == -1
+
+## See also
+## ========
+## * `tables module <tables.html>`_ for the ordered and counting variants
+
+import std/[hashes, bitops]
+
+when defined(nimPreviewSlimSystem):
+  import std/assertions
+
+type
+  FlatTable*[A, B] = object
+    ## Generic hash table with control bytes, consisting of a key-value pair.
+    ctrl: seq[uint8] # one byte per slot, followed by a copy of the first
+                     # `groupWidth` bytes so that any group can be loaded
+                     # without wrapping around
+    data: seq[tuple[hcode: Hash, key: A, val: B]]
+    counter: int
+
+const
+  ctrlEmpty = 0x80'u8
+  groupWidth = 8
+  defaultInitialSize = 32
+  useWords = not defined(js) and not defined(nimscript)
+
+proc tag(hc: Hash): uint8 {.inline.} =
+  uint8((uint(hc) shr (sizeof(Hash) * 8 - 7)) and 0x7f)
+
+when useWords:
+  proc loadGroup(ctrl: seq[uint8], pos: int): uint64 {.inline.} =
+    copyMem(addr result, addr ctrl[pos], groupWidth)
+
+  proc matchByte(g: uint64, b: uint8): uint64 {.inline.} =
+    # the high bit of every byte of `g` that is `b` is set
+    const lo7 = 0x7f7f7f7f7f7f7f7f'u64
+    let x = g xor (0x0101010101010101'u64 * uint64(b))
+    result = not (((x and lo7) + lo7) or x or lo7)
+
+  proc matchEmpty(g: uint64): uint64 {.inline.} =
+    g and 0x8080808080808080'u64
+
+  proc firstByte(m: uint64): int {.inline.} =
+    when cpuEndian == littleEndian:
+      result = countTrailingZeroBits(m) shr 3
+    else:
+      result = countLeadingZeroBits(m) shr 3
+
+  proc clearFirst(m: uint64): uint64 {.inline.} =
+    when cpuEndian == littleEndian:
+      result = m and (m - 1)
+    else:
+      result = m and not (0x8000_0000_0000_0000'u64 shr countLeadingZeroBits(m))
+
+proc setCtrl[A, B](t: var FlatTable[A, B], i: int, c: uint8) {.inline.} =
+  t.ctrl[i] = c
+  if i < groupWidth:
+    t.ctrl[t.data.len + i] = c
+
+proc findSlot[A, B](t: FlatTable[A, B], key: A, hc: Hash): int =
+  ## returns the slot of `key` or -1.
+  if t.data.len == 0: return -1
+  let mask = t.data.len - 1
+  let tg = tag(hc)
+  var pos = hc and mask
+  template scalar =
+    while t.ctrl[pos] != ctrlEmpty:
+      if t.ctrl[pos] == tg and t.data[pos].hcode == hc and
+          t.data[pos].key == key: return pos
+      pos = (pos + 1) and mask
+    return -1
+  when useWords:
+    when nimvm:
+      scalar()
+    else:
+      while true:
+        let g = loadGroup(t.ctrl, pos)
+        var m = matchByte(g, tg)
+        while m != 0:
+          let i = (pos + firstByte(m)) and mask
+          if t.data[i].hcode == hc and t.data[i].key == key: return i
+          m = clearFirst(m)
+        if matchEmpty(g) != 0: return -1
+        pos = (pos + groupWidth) and mask
+  else:
+    scalar()
+
+proc findEmpty[A, B](t: FlatTable[A, B], hc: Hash): int =
+  ## returns the first empty slot of the probe sequence of `hc`.
+  let mask = t.data.len - 1
+  var pos = hc and mask
+  template scalar =
+    while t.ctrl[pos] != ctrlEmpty:
+      pos = (pos + 1) and mask
+    return pos
+  when useWords:
+    when nimvm:
+      scalar()
+    else:
+      while true:
+        let e = matchEmpty(loadGroup(t.ctrl, pos))
+        if e != 0: return (pos + firstByte(e)) and mask
+        pos = (pos + groupWidth) and mask
+  else:
+    scalar()
+
+proc slotsNeeded(count: Natural): int =
+  # the load factor is kept at or below 7/8
+  result = groupWidth
+  while result * 7 < count * 8 + 8: result = result * 2
+
+proc resize[A, B](t: var FlatTable[A, B], slots: int) =
+  var oldData = move t.data
+  let oldCtrl = move t.ctrl
+  newSeq(t.data, slots)
+  t.ctrl = newSeq[uint8](slots + groupWidth)
+  for c in mitems(t.ctrl): c = ctrlEmpty
+  for i in 0 ..< oldData.len:
+    if oldCtrl[i] != ctrlEmpty:
+      let j = findEmpty(t, oldData[i].hcode)
+      setCtrl(t, j, oldCtrl[i])
+      t.data[j] = move oldData[i]
+
+proc initFlatTable*[A, B](initialSize = defaultInitialSize): FlatTable[A, B] =
+  ## Creates a new hash table that is empty. It can hold `initialSize`
+  ## entries without growing.
+  ##
+  ## Like `Table`, a `FlatTable` is initialized by default and it is not
+  ## necessary to call this function explicitly.
+  resize(result, slotsNeeded(initialSize))
+
+proc len*[A, B](t: FlatTable[A, B]): int {.inline.} =
+  ## Returns the number of keys in `t`.
+  t.counter
+
+proc insertNew[A, B](t: var FlatTable[A, B], key: sink A, val: sink B, hc: Hash): int =
+  if t.data.len == 0 or (t.counter + 1) * 8 > t.data.len * 7:
+    resize(t, max(t.data.len * 2, slotsNeeded(defaultInitialSize)))
+  result = findEmpty(t, hc)
+  setCtrl(t, result, tag(hc))
+  t.data[result] = (hc, key, val)
+  inc t.counter
+
+proc `[]=`*[A, B](t: var FlatTable[A, B], key: sink A, val: sink B) =
+  ## Inserts a `(key, value)` pair into `t`, overwriting the value of an
+  ## existing `key`.
+  let hc = hash(key)
+  let i = findSlot(t, key, hc)
+  if i >= 0:
+    t.data[i].val = val
+  else:
+    discard insertNew(t, key, val, hc)
+
+proc raiseKeyError[T](key: T) {.noinline, noreturn.} =
+  when compiles($key):
+    raise newException(KeyError, "key not found: " & $key)
+  else:
+    raise newException(KeyError, "key not found")
+
+proc `[]`*[A, B](t: FlatTable[A, B], key: A): lent B =
+  ## Retrieves the value at `t[key]`. If `key` is not in `t`, the
+  ## `KeyError` exception is raised.
+  let i = findSlot(t, key, hash(key))
+  if i < 0: raiseKeyError(key)
+  t.data[i].val
+
+proc `[]`*[A, B](t: var FlatTable[A, B], key: A): var B =
+  ## Retrieves the value at `t[key]`. The value can be modified.
+  ## If `key` is not in `t`, the `KeyError` exception is raised.
+  let i = findSlot(t, key, hash(key))
+  if i < 0: raiseKeyError(key)
+  t.data[i].val
+
+proc hasKey*[A, B](t: FlatTable[A, B], key: A): bool =
+  ## Returns true if `key` is in the table `t`.
+  findSlot(t, key, hash(key)) >= 0
+
+proc contains*[A, B](t: FlatTable[A, B], key: A): bool =
+  ## Alias of `hasKey` for use with the `in` operator.
+  hasKey(t, key)
+
+proc getOrDefault*[A, B](t: FlatTable[A, B], key: A): B =
+  ## Retrieves the value at `t[key]` if `key` is in `t`. Otherwise, the
+  ## default initialization value for type `B` is returned.
+  let i = findSlot(t, key, hash(key))
+  if i >= 0: result = t.data[i].val
+  else: result = default(B)
+
+proc getOrDefault*[A, B](t: FlatTable[A, B], key: A, def: B): B =
+  ## Retrieves the value at `t[key]` if `key` is in `t`.
+  ## Otherwise, `def` is returned.
+  let i = findSlot(t, key, hash(key))
+  if i >= 0: result = t.data[i].val
+  else: result = def
+
+proc mgetOrPut*[A, B](t: var FlatTable[A, B], key: A, val: B): var B =
+  ## Retrieves the value at `t[key]` or puts `val` if not present, either
+  ## way returning a value which can be modified.
+  let hc = hash(key)
+  var i = findSlot(t, key, hc)
+  if i < 0: i = insertNew(t, key, val, hc)
+  t.data[i].val
+
+proc hasKeyOrPut*[A, B](t: var FlatTable[A, B], key: A, val: B): bool =
+  ## Returns true if `key` is in the table, otherwise inserts `val`.
+  let hc = hash(key)
+  result = findSlot(t, key, hc) >= 0
+  if not result: discard insertNew(t, key, val, hc)
+
+proc delSlot[A, B](t: var FlatTable[A, B], i: int) =
+  # backward shift deletion: every entry after the hole that may live there
+  # moves into it, so no probe sequence is ever interrupted
+  let mask = t.data.len - 1
+  var i = i
+  var j = i
+  while true:
+    j = (j + 1) and mask
+    if t.ctrl[j] == ctrlEmpty: break
+    let k = t.data[j].hcode and mask
+    if (if i <= j: i < k and k <= j else: i < k or k <= j):
+      continue # the home of `j` is between the hole and `j`
+    t.data[i] = move t.data[j]
+    setCtrl(t, i, t.ctrl[j])
+    i = j
+  setCtrl(t, i, ctrlEmpty)
+  t.data[i] = default(typeof(t.data[i]))
+  dec t.counter
+
+proc del*[A, B](t: var FlatTable[A, B], key: A) =
+  ## Deletes `key` from hash table `t`. Does nothing if the key does not
+  ## exist.
+  let i = findSlot(t, key, hash(key))
+  if i >= 0: delSlot(t, i)
+
+proc pop*[A, B](t: var FlatTable[A, B], key: A, val: var B): bool =
+  ## Deletes the `key` from the table. Returns `true`, if the `key` existed,
+  ## and sets `val` to the mapping of the key. Otherwise, returns `false`,
+  ## and the `val` is unchanged.
+  let i = findSlot(t, key, hash(key))
+  result = i >= 0
+  if result:
+    val = move t.data[i].val
+    delSlot(t, i)
+
+proc clear*[A, B](t: var FlatTable[A, B]) =
+  ## Resets the table so that it is empty.
+  t.counter = 0
+  for c in mitems(t.ctrl): c = ctrlEmpty
+  for e in mitems(t.data): e = default(typeof(e))
+
+template forFull(t, i, body) =
+  let L = t.len
+  for i in 0 ..< t.data.len:
+    if t.ctrl[i] != ctrlEmpty:
+      body
+      assert(t.len == L, "the length of the table changed while iterating over it")
+
+iterator pairs*[A, B](t: FlatTable[A, B]): (A, B) =
+  ## Iterates over any `(key, value)` pair in the table `t`.
+  forFull(t, i):
+    yield (t.data[i].key, t.data[i].val)
+
+iterator mpairs*[A, B](t: var FlatTable[A, B]): (A, var B) =
+  ## Iterates over any `(key, value)` pair in the table `t`. The values can
+  ## be modified.
+  forFull(t, i):
+    yield (t.data[i].key, t.data[i].val)
+
+iterator keys*[A, B](t: FlatTable[A, B]): lent A =
+  ## Iterates over any key in the table `t`.
+  forFull(t, i):
+    yield t.data[i].key
+
+iterator values*[A, B](t: FlatTable[A, B]): lent B =
+  ## Iterates over any value in the table `t`.
+  forFull(t, i):
+    yield t.data[i].val
+
+iterator mvalues*[A, B](t: var FlatTable[A, B]): var B =
+  ## Iterates over any value in the table `t`. The values can be modified.
+  forFull(t, i):
+    yield t.data[i].val
+
+proc toFlatTable*[A, B](pairs: openArray[(A, B)]): FlatTable[A, B] =
+  ## Creates a new hash table that contains the given `pairs`.
+  result = initFlatTable[A, B](pairs.len)
+  for key, val in items(pairs): result[key] = val
+
+proc `$`*[A, B](t: FlatTable[A, B]): string =
+  ## The `$` operator for hash tables.
+  if t.len == 0:
+    result = "{:}"
+  else:
+    result = "{"
+    for key, val in pairs(t):
+      if result.len > 1: result.add(", ")
+      result.addQuoted(key)
+      result.add(": ")
+      result.addQuoted(val)
+    result.add("}")
+
+proc `==`*[A, B](s, t: FlatTable[A, B]): bool =
+  ## The `==` operator for hash tables. Returns `true` if the content of both
+  ## tables contains the same key-value pairs. Insert order does not matter.
+  if s.len != t.len: return false
+  for key, val in pairs(s):
+    let i = findSlot(t, key, hash(key))
+    if i < 0 or t.data[i].val != val: return false
+  result = true
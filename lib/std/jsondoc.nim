@@ -0,0 +1,374 @@
+#
+#
+#            Nim's Runtime Library
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## This module implements `JsonDoc`, an immutable, compact representation of
+## a parsed JSON document. Instead of one `ref` per value and an
+## `OrderedTable` per object like `JsonNode`, a document is a single flat
+## array of fixed size entries (a "tape") in document order, plus a single
+## string arena holding all keys and string values. Parsing a document
+## therefore costs two allocations that grow geometrically, and the garbage
+## collector only ever sees the document itself.
+##
+## Values are accessed through `JsonView`, a cheap handle to an entry of the
+## tape that supports the familiar read accessors of `std/json`. Subtrees can
+## be converted to a `JsonNode` on demand with `toJsonNode`.
+##
+## Unlike a `JsonNode`, an object keeps all pairs of a duplicate key, in
+## document order: `len`, `pairs`, `keys` and `$` see every pair, while
+## `[]`, `{}`, `hasKey` and `toJsonNode` use the last value of the key, like
+## `parseJson` does.
+##
+## See also
+## ========
+## * `std/json <json.html>`_
+runnableExamples:
+  import std/json
+  let doc = parseJsonDoc("""{"name": "Nim", "tags": ["fast", "safe"], "v": 2}""")
+  let root = doc.root
+  assert root["name"].getStr == "Nim"
+  assert root["tags"].len == 2
+  assert root{"tags"}[1].getStr == "safe"
+  assert root{"missing", "key"}.isNil
+  var keys: seq[string]
+  for k, v in root.pairs: keys.add k
+  assert keys == @["name", "tags", "v"]
+  assert root.toJsonNode == parseJson($root)
+
+import std/[json, parsejson, streams]
+
+when defined(nimPreviewSlimSystem):
+  import std/[assertions, formatfloat]
+
+type
+  TapeEntry = object
+    kind: JsonNodeKind
+    isUnquoted: bool # a number that does not fit into an int64 or a float
+    len: int32       # JString: bytes; JArray: elements; JObject: pairs
+    span: int32      # number of entries of the value, including this one
+    val: int64       # JInt: value; JFloat: bits; JBool: 0/1;
+                     # JString: offset into `strings`
+
+  JsonDoc* = ref object ## An immutable parsed JSON document.
+    tape: seq[TapeEntry]
+    strings: string
+
+  JsonView* = object ## A value within a `JsonDoc`; a nil view stands for a
+                     ## missing value.
+    doc: JsonDoc
+    pos: int
+
+const DepthLimit = 1000
+
+proc addString(doc: JsonDoc, s: string, isUnquoted = false) =
+  doc.tape.add TapeEntry(kind: JString, isUnquoted: isUnquoted,
+                         len: int32(s.len), span: 1, val: doc.strings.len)
+  doc.strings.add s
+
+proc parseValue(doc: JsonDoc, p: var JsonParser, depth: int) =
+  case p.tok
+  of tkString:
+    doc.addString(p.a)
+    discard getTok(p)
+  of tkInt:
+    try:
+      doc.tape.add TapeEntry(kind: JInt, span: 1, val: parseBiggestInt(p.a))
+    except ValueError:
+      doc.addString(p.a, isUnquoted = true)
+    discard getTok(p)
+  of tkFloat:
+    try:
+      doc.tape.add TapeEntry(kind: JFloat, span: 1,
+                             val: cast[int64](parseFloat(p.a)))
+    except ValueError:
+      doc.addString(p.a, isUnquoted = true)
+    discard getTok(p)
+  of tkTrue, tkFalse:
+    doc.tape.add TapeEntry(kind: JBool, span: 1, val: ord(p.tok == tkTrue))
+    discard getTok(p)
+  of tkNull:
+    doc.tape.add TapeEntry(kind: JNull, span: 1)
+    discard getTok(p)
+  of tkCurlyLe:
+    if depth > DepthLimit:
+      raiseParseErr(p, "}")
+    let start = doc.tape.len
+    doc.tape.add TapeEntry(kind: JObject)
+    var n = 0
+    discard getTok(p)
+    while p.tok != tkCurlyRi:
+      if p.tok != tkString:
+        raiseParseErr(p, "string literal as key")
+      doc.addString(p.a)
+      discard getTok(p)
+      eat(p, tkColon)
+      parseValue(doc, p, depth+1)
+      inc n
+      if p.tok != tkComma: break
+      discard getTok(p)
+    eat(p, tkCurlyRi)
+    doc.tape[start].len = int32(n)
+    doc.tape[start].span = int32(doc.tape.len - start)
+  of tkBracketLe:
+    if depth > DepthLimit:
+      raiseParseErr(p, "]")
+    let start = doc.tape.len
+    doc.tape.add TapeEntry(kind: JArray)
+    var n = 0
+    discard getTok(p)
+    while p.tok != tkBracketRi:
+      parseValue(doc, p, depth+1)
+      inc n
+      if p.tok != tkComma: break
+      discard getTok(p)
+    eat(p, tkBracketRi)
+    doc.tape[start].len = int32(n)
+    doc.tape[start].span = int32(doc.tape.len - start)
+  of tkError, tkCurlyRi, tkBracketRi, tkColon, tkComma, tkEof:
+    raiseParseErr(p, "{")
+
+proc parseJsonDoc*(s: Stream, filename: string = ""): JsonDoc =
+  ## Parses from a stream `s` into a `JsonDoc`. `filename` is only needed
+  ## for nice error messages. If `s` contains extra data, it will raise
+  ## `JsonParsingError`. This closes the stream `s` after it's done.
+  ##
+  ## Numbers that do not fit into an `int64` or a `float` are kept as raw
+  ## numbers, like `parseJson` does. Duplicate keys are kept; lookups return
+  ## the last value of a key. A document can have at most `high(int32)`
+  ## values.
+  result = JsonDoc()
+  var p: JsonParser
+  p.open(s, filename)
+  try:
+    discard getTok(p) # read first token
+    result.parseValue(p, 0)
+    eat(p, tkEof) # check if there is no extra data
+  finally:
+    p.close()
+
+proc parseJsonDoc*(buffer: string): JsonDoc =
+  ## Parses JSON from `buffer` into a `JsonDoc`.
+  ## If `buffer` contains extra data, it will raise `JsonParsingError`.
+  result = parseJsonDoc(newStringStream(buffer), "input")
+
+proc root*(doc: JsonDoc): JsonView {.inline.} =
+  ## Returns the top level value of `doc`.
+  JsonView(doc: doc, pos: 0)
+
+proc isNil*(v: JsonView): bool {.inline.} =
+  ## Returns true for the missing value returned by `{}`.
+  v.doc == nil
+
+template entry(v: JsonView): TapeEntry = v.doc.tape[v.pos]
+
+proc kind*(v: JsonView): JsonNodeKind {.inline.} =
+  ## Returns the kind of `v`, which must not be nil.
+  assert(not isNil(v))
+  v.entry.kind
+
+proc len*(v: JsonView): int =
+  ## If `v` is a `JArray`, it returns the number of elements.
+  ## If `v` is a `JObject`, it returns the number of pairs, which counts
+  ## every pair of a duplicate key, unlike `json.len`.
+  ## Else it returns 0.
+  if not isNil(v) and v.entry.kind in {JArray, JObject}:
+    result = v.entry.len
+  else:
+    result = 0
+
+proc strEq(doc: JsonDoc, e: TapeEntry, s: string): bool =
+  if e.len != s.len: return false
+  let off = int(e.val)
+  for i in 0 ..< s.len:
+    if doc.strings[off + i] != s[i]: return false
+  result = true
+
+proc arenaStr(doc: JsonDoc, e: TapeEntry): string {.inline.} =
+  substr(doc.strings, int(e.val), int(e.val) + e.len - 1)
+
+proc getStr*(v: JsonView, default: string = ""): string =
+  ## Retrieves the string value of a `JString` value.
+  ##
+  ## Returns `default` if `v` is not a `JString`, or if `v` is nil.
+  if isNil(v) or v.entry.kind != JString: default
+  else: arenaStr(v.doc, v.entry)
+
+proc getBiggestInt*(v: JsonView, default: BiggestInt = 0): BiggestInt =
+  ## Retrieves the BiggestInt value of a `JInt` value.
+  ##
+  ## Returns `default` if `v` is not a `JInt`, or if `v` is nil.
+  if isNil(v) or v.entry.kind != JInt: default
+  else: v.entry.val
+
+proc getInt*(v: JsonView, default: int = 0): int =
+  ## Retrieves the int value of a `JInt` value.
+  ##
+  ## Returns `default` if `v` is not a `JInt`, or if `v` is nil.
+  if isNil(v) or v.entry.kind != JInt: default
+  else: int(v.entry.val)
+
+proc getFloat*(v: JsonView, default: float = 0.0): float =
+  ## Retrieves the float value of a `JFloat` value.
+  ##
+  ## Returns `default` if `v` is not a `JFloat` or `JInt`, or if `v` is nil.
+  if isNil(v): return default
+  case v.entry.kind
+  of JFloat: result = cast[float](v.entry.val)
+  of JInt: result = float(v.entry.val)
+  else: result = default
+
+proc getBool*(v: JsonView, default: bool = false): bool =
+  ## Retrieves the bool value of a `JBool` value.
+  ##
+  ## Returns `default` if `v` is not a `JBool`, or if `v` is nil.
+  if isNil(v) or v.entry.kind != JBool: default
+  else: v.entry.val != 0
+
+iterator items*(v: JsonView): JsonView =
+  ## Iterator for the items of `v`. `v` has to be a JArray.
+  assert v.kind == JArray, ": items() can not iterate a JsonView of kind " & $v.kind
+  var pos = v.pos + 1
+  for _ in 0 ..< v.entry.len:
+    yield JsonView(doc: v.doc, pos: pos)
+    pos += int(v.doc.tape[pos].span)
+
+iterator pairs*(v: JsonView): tuple[key: string, val: JsonView] =
+  ## Iterator for the child elements of `v`. `v` has to be a JObject.
+  ## Every pair of a duplicate key is yielded, in document order, unlike
+  ## `json.pairs`.
+  assert v.kind == JObject, ": pairs() can not iterate a JsonView of kind " & $v.kind
+  var pos = v.pos + 1
+  for _ in 0 ..< v.entry.len:
+    yield (arenaStr(v.doc, v.doc.tape[pos]), JsonView(doc: v.doc, pos: pos + 1))
+    pos += 1 + int(v.doc.tape[pos + 1].span)
+
+iterator keys*(v: JsonView): string =
+  ## Iterator for the keys in `v`. `v` has to be a JObject. A duplicate key
+  ## is yielded once per pair.
+  for key, _ in pairs(v):
+    yield key
+
+proc find(v: JsonView, key: string): int =
+  # the position of the value of the last `key` pair or -1
+  result = -1
+  var pos = v.pos + 1
+  for _ in 0 ..< v.entry.len:
+    if strEq(v.doc, v.doc.tape[pos], key):
+      result = pos + 1
+    pos += 1 + int(v.doc.tape[pos + 1].span)
+
+proc `[]`*(v: JsonView, name: string): JsonView =
+  ## Gets a field from a `JObject`, which must not be nil.
+  ## If the value at `name` does not exist, raises KeyError.
+  assert(not isNil(v))
+  assert(v.kind == JObject)
+  let pos = find(v, name)
+  if pos < 0:
+    raise newException(KeyError, "key not found: " & name)
+  result = JsonView(doc: v.doc, pos: pos)
+
+proc `[]`*(v: JsonView, index: int): JsonView =
+  ## Gets the value at `index` in an array. This skips over the preceding
+  ## elements, so use `items` to visit all of them. Raises `IndexDefect`
+  ## if `index` is out of bounds.
+  assert(not isNil(v))
+  assert(v.kind == JArray)
+  if index < 0 or index >= v.entry.len:
+    raise newException(IndexDefect,
+      "index " & $index & " not in 0 .. " & $(v.entry.len - 1))
+  var pos = v.pos + 1
+  for _ in 0 ..< index:
+    pos += int(v.doc.tape[pos].span)
+  result = JsonView(doc: v.doc, pos: pos)
+
+proc hasKey*(v: JsonView, key: string): bool =
+  ## Checks if `key` exists in `v`.
+  assert(v.kind == JObject)
+  find(v, key) >= 0
+
+proc contains*(v: JsonView, key: string): bool =
+  ## Checks if `key` exists in `v`.
+  hasKey(v, key)
+
+proc `{}`*(v: JsonView, keys: varargs[string]): JsonView =
+  ## Traverses `v` and gets the given value. If any of the keys do not
+  ## exist, returns a nil view. Also returns a nil view if one of the
+  ## intermediate values is not an object.
+  result = v
+  for key in keys:
+    if isNil(result) or result.kind != JObject:
+      return JsonView()
+    let pos = find(result, key)
+    if pos < 0:
+      return JsonView()
+    result.pos = pos
+
+proc toJsonNode*(v: JsonView): JsonNode =
+  ## Converts `v` and its children to a `JsonNode`. Returns nil for a nil
+  ## view. Only the requested subtree is materialized.
+  if isNil(v): return nil
+  let e = v.entry
+  case e.kind
+  of JString:
+    # `parseJson` is the only way to create a raw number node
+    if e.isUnquoted: result = parseJson(arenaStr(v.doc, e))
+    else: result = newJString(arenaStr(v.doc, e))
+  of JInt: result = newJInt(e.val)
+  of JFloat: result = newJFloat(cast[float](e.val))
+  of JBool: result = newJBool(e.val != 0)
+  of JNull: result = newJNull()
+  of JArray:
+    result = newJArray()
+    for x in items(v):
+      result.add toJsonNode(x)
+  of JObject:
+    result = newJObject()
+    for key, val in pairs(v):
+      result[key] = toJsonNode(val)
+
+proc toUgly*(result: var string, v: JsonView) =
+  ## Converts `v` to its JSON representation on one line, like
+  ## `json.toUgly`. The JSON representation is stored in `result`.
+  let e = v.entry
+  case e.kind
+  of JArray:
+    result.add "["
+    var comma = false
+    for x in items(v):
+      if comma: result.add ","
+      else: comma = true
+      result.toUgly x
+    result.add "]"
+  of JObject:
+    result.add "{"
+    var comma = false
+    for key, val in pairs(v):
+      if comma: result.add ","
+      else: comma = true
+      key.escapeJson(result)
+      result.add ":"
+      result.toUgly val
+    result.add "}"
+  of JString:
+    if e.isUnquoted:
+      result.add arenaStr(v.doc, e)
+    else:
+      escapeJson(arenaStr(v.doc, e), result)
+  of JInt:
+    result.addInt(e.val)
+  of JFloat:
+    result.addFloat(cast[float](e.val))
+  of JBool:
+    result.add(if e.val != 0: "true" else: "false")
+  of JNull:
+    result.add "null"
+
+proc `$`*(v: JsonView): string =
+  ## Converts `v` to its JSON representation on one line.
+  if isNil(v): return "nil"
+  toUgly(result, v)
@@ -16,7 +16,7 @@ runnableExamples:
   assert 0.0.toJson.kind == JFloat
   assert Inf.toJson.kind == JString
 
-import std/[json, strutils, tables, sets, strtabs, options, strformat]
+import std/[json, strutils, tables, sets, strtabs, options, strformat, parsejson, streams]
 
 #[
 Future directions:
@@ -32,10 +32,11 @@ add a way to customize serialization, for e.g.:
 
 import std/macros
 from std/enumutils import symbolName
-from std/typetraits import OrdinalEnum, tupleLen
+from std/typetraits import OrdinalEnum, tupleLen, genericParams, get
+import std/private/since
 
 when defined(nimPreviewSlimSystem):
-  import std/assertions
+  import std/[assertions, formatfloat]
 
 
 proc isNamedTuple(T: typedesc): bool {.magic: "TypeTrait".}
@@ -295,6 +296,297 @@ proc jsonTo*(b: JsonNode, T: typedesc, opt = Joptions()): T =
   ## reverse of `toJson`
   fromJson(result, b, opt)
 
+const DepthLimit = 1000
+
+proc tokJsonKind(tok: TokKind): JsonNodeKind =
+  case tok
+  of tkString: JString
+  of tkInt: JInt
+  of tkFloat: JFloat
+  of tkTrue, tkFalse: JBool
+  of tkCurlyLe: JObject
+  of tkBracketLe: JArray
+  else: JNull
+
+proc raiseKindError(p: JsonParser, kinds: set[JsonNodeKind]) {.noinline, noreturn.} =
+  if p.tok notin {tkString..tkNull, tkCurlyLe, tkBracketLe}:
+    raiseParseErr(p, "{")
+  let loc = "$1($2, $3)" % [p.getFilename, $p.getLine, $p.getColumn]
+  let msg = "Incorrect JSON kind. Wanted '$1' in '$2' but got '$3'." % [
+    $kinds, loc, $tokJsonKind(p.tok)]
+  raise newException(JsonKindError, msg)
+
+template expectTok(p: JsonParser, toks: set[TokKind], kinds: set[JsonNodeKind]) =
+  if p.tok notin toks: raiseKindError(p, kinds)
+
+template forJsonItems(p: var JsonParser, depth: int, body: untyped) =
+  expectTok(p, {tkBracketLe}, {JArray})
+  if depth > DepthLimit:
+    raiseParseErr(p, "]")
+  discard getTok(p)
+  while p.tok != tkBracketRi:
+    body
+    if p.tok != tkComma: break
+    discard getTok(p)
+  eat(p, tkBracketRi)
+
+template forJsonPairs(p: var JsonParser, depth: int, body: untyped) =
+  ## `body` sees the key in `p.a`; it has to consume the key, the colon and
+  ## the value.
+  expectTok(p, {tkCurlyLe}, {JObject})
+  if depth > DepthLimit:
+    raiseParseErr(p, "}")
+  discard getTok(p)
+  while p.tok != tkCurlyRi:
+    if p.tok != tkString:
+      raiseParseErr(p, "string literal as key")
+    body
+    if p.tok != tkComma: break
+    discard getTok(p)
+  eat(p, tkCurlyRi)
+
+proc skipJson(p: var JsonParser, depth: int) =
+  case p.tok
+  of tkString, tkInt, tkFloat, tkTrue, tkFalse, tkNull:
+    discard getTok(p)
+  of tkBracketLe:
+    forJsonItems(p, depth):
+      skipJson(p, depth+1)
+  of tkCurlyLe:
+    forJsonPairs(p, depth):
+      discard getTok(p)
+      eat(p, tkColon)
+      skipJson(p, depth+1)
+  else:
+    raiseParseErr(p, "{")
+
+proc fieldCount[T](a: T): int =
+  for _ in fields(a): inc result
+
+proc readJson[T](p: var JsonParser, a: var T, opt: Joptions, depth: int)
+
+proc raiseKeysError(p: JsonParser, line, col: int, msg: string) {.noinline.} =
+  # the object has been consumed by now, so the message points to its start
+  # instead of showing it like `fromJson`
+  raise newException(ValueError, "$1($2, $3) Error: $4" % [
+    p.getFilename, $line, $col, msg])
+
+template readJsonFields(p, a, opt, depth) =
+  # the key is matched against the field names before the parser moves on,
+  # so no key string is ever allocated
+  type T = typeof(a)
+  const num = fieldCount(default(T))
+  var seen: array[num, bool]
+  var numKeys, numMatched = 0
+  let line = p.getLine
+  let col = p.getColumn
+  forJsonPairs(p, depth):
+    inc numKeys
+    var idx = -1
+    var i = 0
+    for k, _ in fieldPairs(a):
+      if idx < 0 and p.a == k: idx = i
+      inc i
+    discard getTok(p)
+    eat(p, tkColon)
+    if idx < 0:
+      skipJson(p, depth+1)
+    else:
+      if not seen[idx]:
+        seen[idx] = true
+        inc numMatched
+      else:
+        dec numKeys
+      i = 0
+      for _, val in fieldPairs(a):
+        if i == idx:
+          readJson(p, val, opt, depth+1)
+        inc i
+  if numMatched < num and not opt.allowMissingKeys:
+    var i = 0
+    for key, _ in fieldPairs(a):
+      if not seen[i]:
+        raiseKeysError(p, line, col, "key '$1' for $2 not in object" % [key, $T])
+      inc i
+  if numKeys != numMatched and not opt.allowExtraKeys:
+    raiseKeysError(p, line, col, "There were $1 keys (expecting $2) for $3" %
+      [$numKeys, $num, $T])
+
+proc readJson[T](p: var JsonParser, a: var T, opt: Joptions, depth: int) =
+  ## Decodes the JSON value starting at the current token of `p` into `a`,
+  ## following the same rules as `fromJson`.
+  when T is Option:
+    type E = genericParams(T).get(0)
+    if p.tok == tkNull:
+      a = none(E)
+      discard getTok(p)
+    else:
+      var val: E
+      readJson(p, val, opt, depth)
+      a = some(move val)
+  elif T is (Table | OrderedTable):
+    when genericParams(T).get(0) is string:
+      type V = genericParams(T).get(1)
+      clear(a)
+      forJsonPairs(p, depth):
+        let key = move p.a
+        discard getTok(p)
+        eat(p, tkColon)
+        var val: V
+        readJson(p, val, opt, depth+1)
+        a[key] = move val
+    else:
+      fromJson(a, parseJson(p, false, false, depth), opt)
+  elif T is (HashSet | OrderedSet):
+    type E = genericParams(T).get(0)
+    clear(a)
+    forJsonItems(p, depth):
+      var val: E
+      readJson(p, val, opt, depth+1)
+      incl(a, val)
+  elif compiles(fromJsonHook(a, default(JsonNode), opt)) or
+       compiles(fromJsonHook(a, default(JsonNode))):
+    # hooks work on trees; only the value they consume is materialized
+    fromJson(a, parseJson(p, false, false, depth), opt)
+  elif T is bool:
+    expectTok(p, {tkTrue, tkFalse}, {JBool})
+    a = p.tok == tkTrue
+    discard getTok(p)
+  elif T is enum:
+    case p.tok
+    of tkInt: a = T(parseBiggestInt(p.a))
+    of tkString: a = parseEnum[T](p.a)
+    else: checkJson false, fmt"Expecting int/string for {$T} got {tokJsonKind(p.tok)}"
+    discard getTok(p)
+  elif T is uint|uint64:
+    expectTok(p, {tkInt, tkString}, {JInt, JString})
+    a = T(parseBiggestUInt(p.a))
+    discard getTok(p)
+  elif T is Ordinal:
+    expectTok(p, {tkInt}, {JInt})
+    a = cast[T](int(parseBiggestInt(p.a)))
+    discard getTok(p)
+  elif T is pointer:
+    expectTok(p, {tkInt}, {JInt})
+    a = cast[pointer](int(parseBiggestInt(p.a)))
+    discard getTok(p)
+  elif T is distinct: readJson(p, a.distinctBase, opt, depth)
+  elif T is string:
+    expectTok(p, {tkString, tkNull}, {JString, JNull})
+    if p.tok == tkNull: a = ""
+    else: a = move p.a
+    discard getTok(p)
+  elif T is cstring:
+    # `fromJson` points `a` into the string of the tree, which would be gone
+    # by the time `parseJsonTo` returns
+    {.error: "parseJsonTo can't decode " & $T & ", use string instead".}
+  elif T is SomeFloat:
+    expectTok(p, {tkInt, tkFloat, tkString}, {JInt, JFloat, JString})
+    if p.tok == tkString:
+      # going through `b` avoids compile time range errors for range types
+      case p.a
+      of "nan":
+        let b = NaN
+        a = T(b)
+      of "inf":
+        let b = Inf
+        a = T(b)
+      of "-inf":
+        let b = -Inf
+        a = T(b)
+      else: raise newException(JsonKindError, "expected 'nan|inf|-inf', got " & p.a)
+    else:
+      a = T(parseFloat(p.a))
+    discard getTok(p)
+  elif T is JsonNode: a = parseJson(p, false, false, depth)
+  elif T is ref | ptr:
+    if p.tok == tkNull:
+      a = nil
+      discard getTok(p)
+    else:
+      a = T()
+      readJson(p, a[], opt, depth)
+  elif T is array:
+    var i = 0
+    forJsonItems(p, depth):
+      checkJson i < a.len, fmt"Json array size doesn't match for {$T}"
+      readJson(p, a[i], opt, depth+1)
+      inc i
+    checkJson i == a.len, fmt"Json array size doesn't match for {$T}"
+  elif T is set:
+    type E = typeof(for ai in a: ai)
+    forJsonItems(p, depth):
+      var val: E
+      readJson(p, val, opt, depth+1)
+      incl a, val
+  elif T is seq:
+    var i = 0
+    forJsonItems(p, depth):
+      if i == a.len: a.setLen(i+1)
+      readJson(p, a[i], opt, depth+1)
+      inc i
+    a.setLen i
+  elif T is object:
+    const keys = getDiscriminants(T)
+    when keys.len == 0:
+      readJsonFields(p, a, opt, depth)
+    else:
+      # the branch depends on discriminants that can come after the
+      # fields they select, so case objects are decoded from a tree
+      fromJson(a, parseJson(p, false, false, depth), opt)
+  elif T is tuple:
+    when isNamedTuple(T):
+      readJsonFields(p, a, opt, depth)
+    else:
+      const tupleSize = fieldCount(default(T))
+      var i = 0
+      forJsonItems(p, depth):
+        checkJson i < tupleSize, fmt"Json doesn't match expected length of {tupleSize}"
+        var j = 0
+        for val in fields(a):
+          if j == i: readJson(p, val, opt, depth+1)
+          inc j
+        inc i
+      checkJson i == tupleSize, fmt"Json doesn't match expected length of {tupleSize}, got {i}"
+  else:
+    static: raiseAssert "not yet implemented: " & $T
+
+proc parseJsonTo*[T](s: Stream, filename = ""; opt = Joptions()): T {.since: (2, 3).} =
+  ## Parses the JSON document in `s` directly into a value of type `T`,
+  ## without building an intermediate `JsonNode` tree. The result is the same
+  ## as `parseJson(s).jsonTo(T, opt)` and the same exception types are
+  ## raised; types with a `fromJsonHook` and case objects are still decoded
+  ## through a `JsonNode` of the value they consume. `cstring` is not
+  ## supported, as there is no tree for it to point into. The message for
+  ## missing or extra keys differs from `jsonTo`: it gives the position of
+  ## the object in `s` instead of the object itself. `filename` is only used
+  ## for error messages. This closes the stream `s` after it's done.
+  runnableExamples:
+    import std/streams
+    type Point = object
+      x, y: int
+    let pts = parseJsonTo[seq[Point]](newStringStream("""[{"x":1,"y":2},{"y":4,"x":3}]"""))
+    assert pts == @[Point(x: 1, y: 2), Point(x: 3, y: 4)]
+  var p: JsonParser
+  p.open(s, filename)
+  try:
+    discard getTok(p) # read first token
+    readJson(p, result, opt, 0)
+    eat(p, tkEof) # check if there is no extra data
+  finally:
+    p.close()
+
+proc parseJsonTo*[T](buffer: string; opt = Joptions()): T {.since: (2, 3).} =
+  ## Parses `buffer` directly into a value of type `T`; see
+  ## `parseJsonTo proc<#parseJsonTo,Stream,string>`_.
+  runnableExamples:
+    type Config = object
+      name: string
+      ports: seq[int]
+    let c = parseJsonTo[Config]("""{"name": "gateway", "ports": [80, 443]}""")
+    assert c.ports == @[80, 443]
+  result = parseJsonTo[T](newStringStream(buffer), "input", opt)
+
 proc toJson*[T](a: T, opt = initToJsonOptions()): JsonNode =
   ## serializes `a` to json; uses `toJsonHook(a: T)` if it's in scope to
   ## customize serialization, see strtabs.toJsonHook for an example.
@@ -491,3 +783,154 @@ proc toJsonHook*(a: StringTableRef): JsonNode =
   let t = newJObject()
   for k,v in a: t[k] = toJson(v)
   result["table"] = t
+
+type
+  JsonWriter* = object
+    ## Serializes values to JSON text in chunks of about `chunkSize` bytes,
+    ## handing each chunk to its output as soon as it is complete, instead of
+    ## building a `JsonNode` and a string for the whole value first.
+    buf: string
+    chunkSize: int
+    output: proc (chunk: string)
+    opt: ToJsonOptions
+
+proc initJsonWriter*(output: proc (chunk: string), opt = initToJsonOptions();
+                     chunkSize = 64 * 1024): JsonWriter {.since: (2, 3).} =
+  ## Creates a writer that passes its output to `output`, which must not
+  ## keep a reference to the chunk; its buffer is reused.
+  ##
+  ## To write to an `AsyncSocket`, enable its write buffer so that the chunks
+  ## are sent in order without waiting for each `send`:
+  ##
+  ## ```nim
+  ## client.setWriteBuffer()
+  ## var w = initJsonWriter(proc (chunk: string) = asyncCheck client.send(chunk))
+  ## w.writeJson(response)
+  ## w.flush()
+  ## await client.flush()
+  ## ```
+  JsonWriter(buf: newStringOfCap(chunkSize), chunkSize: chunkSize,
+             output: output, opt: opt)
+
+proc initJsonWriter*(s: Stream, opt = initToJsonOptions();
+                     chunkSize = 64 * 1024): JsonWriter {.since: (2, 3).} =
+  ## Creates a writer that writes its output to `s`.
+  initJsonWriter(proc (chunk: string) = s.write(chunk), opt, chunkSize)
+
+proc flush*(w: var JsonWriter) {.since: (2, 3).} =
+  ## Passes the buffered output of `w` to its output.
+  if w.buf.len > 0:
+    w.output(w.buf)
+    w.buf.setLen 0
+
+proc writeJson*[T](w: var JsonWriter, a: T) {.since: (2, 3).} =
+  ## Appends the JSON representation of `a` to `w`; the output is the same as
+  ## `$toJson(a, opt)`. Call `flush` after the last value.
+  ##
+  ## Options, string keyed tables and hash sets are written directly; other
+  ## types with a `toJsonHook` are written through the `JsonNode` the hook
+  ## returns.
+  var needComma {.used.} = false
+  template comma() =
+    if needComma: w.buf.add ','
+    else: needComma = true
+  when T is Option:
+    if isSome(a): writeJson(w, get(a))
+    else: w.buf.add "null"
+  elif T is (Table | OrderedTable):
+    when genericParams(T).get(0) is (string | cstring):
+      w.buf.add '{'
+      for k, v in pairs(a):
+        comma()
+        escapeJson((when k is string: k else: $k), w.buf)
+        w.buf.add ':'
+        writeJson(w, v)
+      w.buf.add '}'
+    else:
+      toUgly(w.buf, toJson(a, w.opt))
+  elif T is (HashSet | OrderedSet):
+    w.buf.add '['
+    for x in items(a):
+      comma()
+      writeJson(w, x)
+    w.buf.add ']'
+  elif compiles(toJsonHook(a, w.opt)): toUgly(w.buf, toJsonHook(a, w.opt))
+  elif compiles(toJsonHook(a)): toUgly(w.buf, toJsonHook(a))
+  elif T is object | tuple:
+    when T is object or isNamedTuple(T):
+      w.buf.add '{'
+      for k, v in a.fieldPairs:
+        comma()
+        escapeJson(k, w.buf)
+        w.buf.add ':'
+        writeJson(w, v)
+      w.buf.add '}'
+    else:
+      w.buf.add '['
+      for v in a.fields:
+        comma()
+        writeJson(w, v)
+      w.buf.add ']'
+  elif T is ref | ptr:
+    template impl =
+      if system.`==`(a, nil): w.buf.add "null"
+      else: writeJson(w, a[])
+    when T is JsonNode:
+      case w.opt.jsonNodeMode
+      of joptJsonNodeAsRef, joptJsonNodeAsCopy:
+        if a.isNil: w.buf.add "null"
+        else: toUgly(w.buf, a)
+      of joptJsonNodeAsObject: impl()
+    else: impl()
+  elif T is array | seq | set:
+    w.buf.add '['
+    for ai in a:
+      comma()
+      writeJson(w, ai)
+    w.buf.add ']'
+  elif T is pointer: w.buf.addInt cast[int](a)
+  elif T is distinct: writeJson(w, a.distinctBase)
+  elif T is bool: w.buf.add(if a: "true" else: "false")
+  elif T is SomeUnsignedInt: w.buf.add $a
+  elif T is SomeInteger: w.buf.addInt BiggestInt(a)
+  elif T is enum:
+    case w.opt.enumMode
+    of joptEnumOrd:
+      when T is Ordinal or defined(nimPreviewJsonutilsHoleyEnum): w.buf.addInt a.ord
+      else: escapeJson($a, w.buf)
+    of joptEnumSymbol:
+      when T is OrdinalEnum:
+        escapeJson(symbolName(a), w.buf)
+      else:
+        escapeJson($a, w.buf)
+    of joptEnumString: escapeJson($a, w.buf)
+  elif T is Ordinal: w.buf.addInt a.ord
+  elif T is cstring:
+    if a == nil: w.buf.add "null"
+    else: escapeJson($a, w.buf)
+  elif T is string: escapeJson(a, w.buf)
+  elif T is SomeFloat:
+    let f = float(a)
+    # same special cases as `%`
+    if f != f: w.buf.add "\"nan\""
+    elif f == Inf: w.buf.add "\"inf\""
+    elif f == -Inf: w.buf.add "\"-inf\""
+    else: w.buf.addFloat f
+  else: toUgly(w.buf, %a)
+  if w.buf.len >= w.chunkSize:
+    flush(w)
+
+proc writeJson*[T](s: Stream, a: T, opt = initToJsonOptions()) {.since: (2, 3).} =
+  ## Writes the JSON representation of `a` to `s` in chunks; the output is the
+  ## same as `$toJson(a, opt)`.
+  runnableExamples:
+    import std/streams
+    type Reply = object
+      ok: bool
+      items: seq[int]
+    let s = newStringStream()
+    s.writeJson(Reply(ok: true, items: @[1, 2]))
+    assert s.data == """{"ok":true,"items":[1,2]}"""
+  var w = initJsonWriter(s, opt)
+  w.writeJson(a)
+  w.flush()
@@ -0,0 +1,326 @@
+#
+#
+#            Nim's Runtime Library
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## This module implements a CSV reader for large files. The file is memory
+## mapped and the fields of a row are returned as `StrView`\s into the
+## mapping, so reading a row does not copy or allocate anything.
+##
+## A file can be cut into chunks that start and end at row boundaries, also
+## when quoted fields contain line breaks. Every chunk can be read by its own
+## `CsvReader`, for example on its own thread.
+##
+## Fields may be enclosed in quote characters, which are doubled inside
+## quoted fields, as in `RFC 4180 <https://tools.ietf.org/html/rfc4180>`_.
+## Quote characters in fields that do not start with one are not supported.
+##
+##   ```nim
+##   import std/memcsv
+##
+##   var csv = openCsvMap("sales.csv")
+##   var r = initCsvReader(csv.chunk)
+##   discard r.readRow() # the header
+##   var total = 0.0
+##   while r.readRow():
+##     total += r.get(2, float)
+##   csv.close()
+##   ```
+##
+## To read a file on several threads, give each thread one of the chunks of
+## `chunks(csv, n)` and keep the `CsvMap` open until all threads are done.
+##
+## See also
+## ========
+## * `parsecsv module <parsecsv.html>`_ for reading CSV from a `Stream`
+## * `strviews module <strviews.html>`_ for the operations on fields
+
+import std/[memfiles, strviews, os]
+from std/parsecsv import CsvError
+from std/strutils import parseEnum
+
+export strviews, CsvError
+
+when defined(nimPreviewSlimSystem):
+  import std/assertions
+
+type
+  CsvMap* = object ## A memory mapped CSV file.
+    mem: MemFile
+    filename: string
+    sep, quote: char
+
+  CsvChunk* = object ## A range of rows of a CSV file or buffer.
+    data: ptr UncheckedArray[char] # the whole file, for error positions
+    first, last: int
+    filename: string
+    sep, quote: char
+
+  CsvReader* = object ## Reads the rows of a `CsvChunk`.
+    chunk: CsvChunk
+    pos: int
+    fields: seq[StrView]
+    escaped: seq[bool] # whether a field contains doubled quotes
+
+proc c_memchr(cstr: pointer, c: char, n: csize_t): pointer {.
+     importc: "memchr", header: "<string.h>".}
+
+proc findChar(data: ptr UncheckedArray[char], c: char, first, last: int): int {.inline.} =
+  # the position of the first `c` in `data[first ..< last]`, or `last`
+  if first >= last: return last
+  let p = c_memchr(addr data[first], c, csize_t(last - first))
+  result = if p == nil: last else: cast[int](p) -% cast[int](data)
+
+proc openCsvMap*(filename: string, separator = ',', quote = '"'): CsvMap =
+  ## Maps the CSV file `filename` into memory. `quote` can be `'\0'` if
+  ## fields are never quoted. If the file cannot be mapped, `OSError` is
+  ## raised.
+  result = CsvMap(filename: filename, sep: separator, quote: quote)
+  if getFileSize(filename) > 0:
+    result.mem = memfiles.open(filename)
+
+proc close*(m: var CsvMap) =
+  ## Unmaps the file. Views into it must not be used afterwards.
+  if m.mem.mem != nil:
+    m.mem.close()
+
+proc len*(m: CsvMap): int {.inline.} =
+  ## Returns the size of the file in bytes.
+  m.mem.size
+
+proc chunk*(m: CsvMap): CsvChunk =
+  ## Returns the whole file as one chunk.
+  CsvChunk(data: cast[ptr UncheckedArray[char]](m.mem.mem), first: 0,
+           last: m.mem.size, filename: m.filename, sep: m.sep, quote: m.quote)
+
+proc toCsvChunk*(s: openArray[char], separator = ',', quote = '"'): CsvChunk =
+  ## Returns a chunk for reading the CSV data in `s`, which must outlive the
+  ## chunk and the views read from it.
+  runnableExamples:
+    let data = "a,b\n1,\"x, \"\"y\"\"\"\n"
+    var r = initCsvReader(toCsvChunk(data))
+    assert r.readRow() and r[0] == "a"
+    assert r.readRow()
+    assert r.get(0, int) == 1
+    assert r.getStr(1) == "x, \"y\""
+    assert not r.readRow()
+  result = CsvChunk(first: 0, last: s.len, sep: separator, quote: quote)
+  if s.len > 0:
+    result.data = cast[ptr UncheckedArray[char]](unsafeAddr s[0])
+
+proc chunks*(m: CsvMap, n: Positive): seq[CsvChunk] =
+  ## Splits the file into at most `n` chunks of about the same size, which
+  ## start and end at row boundaries. Line breaks inside quoted fields are
+  ## told apart from row ends by following the quote characters from the
+  ## start of the file, which `memchr` does at memory speed. Rows must end
+  ## with LF or CR LF.
+  let whole = m.chunk
+  let data = whole.data
+  let size = whole.last
+  var start = 0
+  var pos = 0
+  var inQuote = false
+  for k in 1 ..< n:
+    let goal = max(k * size div n, start)
+    if m.quote != '\0':
+      # the quote state at `goal`
+      while true:
+        let q = findChar(data, m.quote, pos, goal)
+        if q >= goal: break
+        inQuote = not inQuote
+        pos = q + 1
+    pos = max(pos, goal)
+    # move on to the end of the row that contains `goal`
+    while pos < size:
+      if inQuote:
+        pos = findChar(data, m.quote, pos, size) + 1
+        inQuote = false
+      else:
+        let nl = findChar(data, '\l', pos, size)
+        let q = if m.quote != '\0': findChar(data, m.quote, pos, nl) else: nl
+        if q < nl:
+          inQuote = true
+          pos = q + 1
+        else:
+          pos = min(nl + 1, size)
+          break
+    pos = min(pos, size)
+    if pos > start:
+      var c = whole
+      c.first = start
+      c.last = pos
+      result.add c
+      start = pos
+  if start < size or result.len == 0:
+    var c = whole
+    c.first = start
+    result.add c
+
+proc len*(c: CsvChunk): int {.inline.} =
+  ## Returns the size of the chunk in bytes.
+  c.last - c.first
+
+proc initCsvReader*(c: CsvChunk): CsvReader =
+  ## Returns a reader for the rows of `c`.
+  CsvReader(chunk: c, pos: c.first)
+
+proc error(r: CsvReader, pos: int, msg: string) {.noreturn.} =
+  # computes the line and column only now, from the start of the data
+  var line = 1
+  var lineStart = 0
+  var i = 0
+  while true:
+    i = findChar(r.chunk.data, '\l', i, pos)
+    if i >= pos: break
+    inc line
+    inc i
+    lineStart = i
+  raise newException(CsvError, r.chunk.filename & "(" & $line & ", " &
+                     $(pos - lineStart + 1) & ") Error: " & msg)
+
+proc readRow*(r: var CsvReader, columns = 0): bool =
+  ## Reads the next row; if `columns` > 0, it expects the row to have
+  ## exactly this many columns. Returns false at the end of the chunk.
+  ##
+  ## Blank lines are skipped. The views returned by `[]` for the previous
+  ## row stay valid.
+  let data = r.chunk.data
+  let last = r.chunk.last
+  let sep = r.chunk.sep
+  let quote = r.chunk.quote
+  var pos = r.pos
+  while pos < last and data[pos] in {'\c', '\l'}: inc pos
+  r.fields.setLen(0)
+  r.escaped.setLen(0)
+  if pos >= last:
+    r.pos = pos
+    return false
+  let rowStart = pos
+  while true:
+    var field: StrView
+    var escaped = false
+    if pos < last and data[pos] == quote and quote != '\0':
+      let first = pos + 1
+      pos = first
+      while true:
+        pos = findChar(data, quote, pos, last)
+        if pos >= last:
+          error(r, first - 1, $quote & " expected")
+        if pos + 1 < last and data[pos + 1] == quote:
+          escaped = true
+          inc(pos, 2)
+        else:
+          break
+      field = toStrView(addr data[first], pos - first)
+      inc pos
+    else:
+      let first = pos
+      while pos < last and data[pos] != sep and data[pos] notin {'\c', '\l'}:
+        inc pos
+      if pos > first:
+        field = toStrView(addr data[first], pos - first)
+    r.fields.add field
+    r.escaped.add escaped
+    if pos >= last: break
+    let c = data[pos]
+    if c == sep:
+      inc pos
+      if pos >= last:
+        # a separator at the very end starts one more, empty field
+        r.fields.add StrView()
+        r.escaped.add false
+        break
+    elif c == '\c' or c == '\l':
+      inc pos
+      if c == '\c' and pos < last and data[pos] == '\l': inc pos
+      break
+    else:
+      error(r, pos, $sep & " expected")
+  r.pos = pos
+  if columns > 0 and r.fields.len != columns:
+    error(r, rowStart, $columns & " columns expected, but found " &
+          $r.fields.len & " columns")
+  result = true
+
+proc len*(r: CsvReader): int {.inline.} =
+  ## Returns the number of fields of the current row.
+  r.fields.len
+
+proc `[]`*(r: CsvReader, i: int): StrView {.inline.} =
+  ## Returns the field `i` of the current row, without the quotes around it.
+  ## Doubled quotes in the field are not undone; see `getStr`.
+  r.fields[i]
+
+proc getStr*(r: CsvReader, i: int): string =
+  ## Returns a copy of the field `i` of the current row, with doubled quotes
+  ## replaced by single ones.
+  let v = r.fields[i]
+  if not r.escaped[i]:
+    return $v
+  result = newStringOfCap(v.len)
+  var j = 0
+  while j < v.len:
+    result.add v[j]
+    if v[j] == r.chunk.quote: inc j
+    inc j
+
+proc eqIgnoreCase(v: StrView, s: string): bool =
+  if v.len != s.len: return false
+  for i in 0 ..< s.len:
+    if (if v[i] in {'A'..'Z'}: char(ord(v[i]) + 32) else: v[i]) != s[i]:
+      return false
+  result = true
+
+proc get*[T](r: CsvReader, i: int, t: typedesc[T]): T =
+  ## Decodes the field `i` of the current row as a value of type `T`, which
+  ## can be an integer, float, bool, enum, `string` or `StrView` type.
+  ## Leading and trailing whitespace around numbers is ignored. Raises
+  ## `ValueError` if the field is not a valid value of `T`.
+  let v = r.fields[i]
+  when T is StrView:
+    result = v
+  elif T is string:
+    result = r.getStr(i)
+  elif T is bool:
+    let s = v.strip
+    for x in ["y", "yes", "true", "1", "on"]:
+      if eqIgnoreCase(s, x): return true
+    for x in ["n", "no", "false", "0", "off"]:
+      if eqIgnoreCase(s, x): return false
+    raise newException(ValueError, "cannot interpret as a bool: " & $v)
+  elif T is enum:
+    result = parseEnum[T](r.getStr(i))
+  elif T is SomeSignedInt:
+    let x = parseBiggestInt(v.strip)
+    if x < BiggestInt(low(T)) or x > BiggestInt(high(T)):
+      raise newException(ValueError, "value out of range: " & $v)
+    result = T(x)
+  elif T is SomeUnsignedInt:
+    let x = parseUInt(v.strip)
+    if uint64(x) > uint64(high(T)):
+      raise newException(ValueError, "value out of range: " & $v)
+    result = T(x)
+  elif T is SomeFloat:
+    result = T(parseFloat(v.strip))
+  else:
+    {.error: "cannot decode a CSV field as " & $T.}
+
+proc getRow*[T: tuple | object](r: CsvReader, t: typedesc[T]): T =
+  ## Decodes the fields of the current row, in order, into the fields of a
+  ## tuple or object with `get`. Raises `ValueError` if the row has fewer
+  ## fields.
+  runnableExamples:
+    type Sale = tuple[item: string, count: int, price: float]
+    var r = initCsvReader(toCsvChunk("pen,3,1.5\n"))
+    assert r.readRow()
+    assert r.getRow(Sale) == (item: "pen", count: 3, price: 1.5)
+  var i = 0
+  for x in fields(result):
+    if i >= r.fields.len:
+      raise newException(ValueError, "row has only " & $r.fields.len & " fields")
+    x = r.get(i, typeof(x))
+    inc i
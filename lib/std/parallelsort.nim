@@ -0,0 +1,221 @@
+#
+#
+#            Nim's Runtime Library
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## This module implements a stable merge sort that uses all cores of the
+## machine. The input is cut into one run per processor, the runs are sorted
+## concurrently with `algorithm.sort` and then merged pairwise. Every merge
+## is itself split between several threads: each thread computes by binary
+## search which part of both runs ends up in its slice of the output, so the
+## last merges keep all cores busy too.
+##
+## The sort needs a temporary sequence of length `a.len`. Small inputs,
+## programs compiled without `--threads:on`, the JS backend and the VM fall
+## back to `algorithm.sort`.
+##
+## The comparison procs run on other threads, so they must not capture
+## local variables, must not raise and must not copy `ref`\s that are shared
+## between elements. With `--mm:refc`, where every thread has its own heap,
+## only types without garbage collected memory are sorted in parallel.
+runnableExamples:
+  import std/algorithm
+  var a = newSeq[int](100_000)
+  for i in 0 ..< a.len: a[i] = (i * 7919) mod 100_003
+  a.parallelSort()
+  assert a.isSorted
+
+  type Person = tuple[name: string, age: int]
+  let people: seq[Person] = @[("p1", 60), ("p2", 20), ("p3", 30), ("p4", 30)]
+  assert people.parallelSortedByIt(it.age) ==
+    @[("p2", 20), ("p3", 30), ("p4", 30), ("p1", 60)]
+
+## See also
+## ========
+## * `algorithm module <algorithm.html>`_ for the sequential sort procs
+
+import std/algorithm
+import std/private/since
+
+export SortOrder
+
+const hasThreads = compileOption("threads") and not defined(js) and
+                   not defined(nimscript)
+
+when hasThreads:
+  import std/[cpuinfo, typedthreads]
+
+  when defined(nimPreviewSlimSystem):
+    import std/assertions
+
+  const minRun = 16_384 # smaller inputs are not worth starting threads for
+
+  type
+    SortJob[T] = object
+      src, dst: ptr UncheckedArray[T]
+      lo, mid, hi: int   # the sorted runs src[lo ..< mid] and src[mid ..< hi]
+      first, last: int   # the part of dst[lo ..< hi] filled by this job
+      cmp: proc (x, y: T): int {.nimcall.} # nil for `system.cmp`
+      order: SortOrder
+      sortOnly: bool     # sort src[lo ..< hi] in place instead of merging
+
+  template mergePart(job, cmp: untyped) =
+    # `T` is the element type of the calling `sortWorker`
+    let
+      x = cast[ptr UncheckedArray[T]](addr job.src[job.lo])
+      y = cast[ptr UncheckedArray[T]](addr job.src[job.mid])
+      z = cast[ptr UncheckedArray[T]](addr job.dst[job.lo])
+      nx = job.mid - job.lo
+      ny = job.hi - job.mid
+
+    template before(u, v: T): bool =
+      # elements of the left run come first among equal ones
+      cmp(u, v) * job.order <= 0
+
+    template coRank(k: int): int =
+      # the number of elements of `x` among the first `k` merged elements
+      var lo = max(0, k - ny)
+      var hi = min(k, nx)
+      while lo < hi:
+        let i = (lo + hi) div 2
+        if before(x[i], y[k - i - 1]): lo = i + 1
+        else: hi = i
+      lo
+
+    var i = coRank(job.first)
+    var j = job.first - i
+    let iEnd = coRank(job.last)
+    let jEnd = job.last - iEnd
+    var k = job.first
+    while i < iEnd and j < jEnd:
+      if before(x[i], y[j]):
+        z[k] = move x[i]
+        inc i
+      else:
+        z[k] = move y[j]
+        inc j
+      inc k
+    while i < iEnd:
+      z[k] = move x[i]
+      inc i
+      inc k
+    while j < jEnd:
+      z[k] = move y[j]
+      inc j
+      inc k
+
+  proc sortWorker[T](job: SortJob[T]) {.thread.} =
+    {.cast(gcsafe).}:
+      if job.sortOnly:
+        if job.cmp == nil:
+          sort(toOpenArray(job.src, job.lo, job.hi - 1), job.order)
+        else:
+          sort(toOpenArray(job.src, job.lo, job.hi - 1), job.cmp, job.order)
+      elif job.cmp == nil:
+        mergePart(job, system.cmp)
+      else:
+        mergePart(job, job.cmp)
+
+  proc sortThreaded[T](a: var openArray[T], cmp: proc (x, y: T): int {.nimcall.},
+                       order: SortOrder) =
+    let n = a.len
+    let workers = min(countProcessors(), n div minRun)
+    var buf = newSeq[T](n)
+    var threads = newSeq[Thread[SortJob[T]]](workers)
+    var src = cast[ptr UncheckedArray[T]](addr a[0])
+    var dst = cast[ptr UncheckedArray[T]](addr buf[0])
+    var bounds = newSeq[int](workers + 1)
+    for w in 0 .. workers:
+      bounds[w] = w * n div workers
+    for w in 0 ..< workers:
+      createThread(threads[w], sortWorker[T], SortJob[T](src: src,
+        lo: bounds[w], hi: bounds[w+1], cmp: cmp, order: order, sortOnly: true))
+    joinThreads(threads)
+
+    while bounds.len > 2:
+      let runs = bounds.len - 1
+      let pairs = runs div 2
+      let parts = max(1, workers div pairs)
+      var next = @[0]
+      var started = 0
+      for p in 0 ..< pairs:
+        let (lo, mid, hi) = (bounds[2*p], bounds[2*p+1], bounds[2*p+2])
+        for part in 0 ..< parts:
+          createThread(threads[started], sortWorker[T], SortJob[T](src: src,
+            dst: dst, lo: lo, mid: mid, hi: hi, first: (hi - lo) * part div parts,
+            last: (hi - lo) * (part + 1) div parts, cmp: cmp, order: order))
+          inc started
+        next.add hi
+      if runs mod 2 == 1:
+        # the odd run out is only moved over
+        let (lo, hi) = (bounds[runs-1], bounds[runs])
+        sortWorker(SortJob[T](src: src, dst: dst, lo: lo, mid: hi, hi: hi,
+          first: 0, last: hi - lo, cmp: cmp, order: order))
+        next.add hi
+      for t in 0 ..< started:
+        joinThread(threads[t])
+      bounds = next
+      swap(src, dst)
+
+    if src != cast[ptr UncheckedArray[T]](addr a[0]):
+      for i in 0 ..< n:
+        a[i] = move buf[i]
+
+proc parallelSortImpl[T](a: var openArray[T], cmp: proc (x, y: T): int {.nimcall.},
+                         order: SortOrder) =
+  template serial =
+    if cmp == nil: sort(a, order)
+    else: sort(a, cmp, order)
+  when nimvm:
+    serial()
+  else:
+    when hasThreads and (defined(gcDestructors) or supportsCopyMem(T)):
+      if a.len >= 2 * minRun and countProcessors() > 1:
+        sortThreaded(a, cmp, order)
+      else:
+        serial()
+    else:
+      serial()
+
+proc parallelSort*[T](a: var openArray[T], cmp: proc (x, y: T): int {.nimcall.},
+                      order = SortOrder.Ascending) {.since: (2, 3).} =
+  ## Sorts `a` by `cmp` in the specified `order` on all processors. Like
+  ## `algorithm.sort` the sort is stable and `cmp` returns the same values
+  ## as `system.cmp`. `cmp` cannot be a closure.
+  runnableExamples:
+    var a = ["boo", "fo", "barr", "qux"]
+    a.parallelSort(proc (x, y: string): int = cmp(x.len, y.len))
+    assert a == ["fo", "boo", "qux", "barr"]
+  parallelSortImpl(a, cmp, order)
+
+proc parallelSort*[T](a: var openArray[T], order = SortOrder.Ascending) {.since: (2, 3).} =
+  ## Shortcut version of `parallelSort` that uses `system.cmp[T]` as the
+  ## comparison function, inlined into the sort.
+  runnableExamples:
+    import std/algorithm
+    var a = @[5, 3, 1, 4, 2]
+    a.parallelSort(Descending)
+    assert a == @[5, 4, 3, 2, 1]
+  parallelSortImpl(a, nil, order)
+
+template parallelSortedByIt*(seq1, op: untyped): untyped =
+  ## Returns a sorted copy of `seq1` like `algorithm.sortedByIt`, but sorts
+  ## it with `parallelSort`. `op` may only refer to `it` and to global
+  ## symbols.
+  runnableExamples:
+    let words = @["banana", "fig", "apple", "kiwi"]
+    assert words.parallelSortedByIt(it.len) == @["fig", "kiwi", "apple", "banana"]
+  var result = @(seq1)
+  parallelSort(result, proc (x, y: typeof(items(seq1), typeOfIter)): int {.nimcall.} =
+    let a = block:
+      let it {.inject, cursor.} = x
+      op
+    let b = block:
+      let it {.inject, cursor.} = y
+      op
+    result = cmp(a, b))
+  result
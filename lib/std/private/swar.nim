@@ -0,0 +1,7 @@
+## Helpers for scanning strings 8 bytes at a time.
+
+func zeroBytes*(x: uint64): uint64 {.inline.} =
+  ## Sets the high bit of every byte of `x` that is zero, without the false
+  ## positives of the borrow based variant.
+  const lo7 = 0x7f7f7f7f7f7f7f7f'u64
+  result = not (((x and lo7) + lo7) or x or lo7)
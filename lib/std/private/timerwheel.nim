@@ -0,0 +1,249 @@
+##[
+unstable API, internal use only for now.
+
+Hierarchical timing wheel used by `asyncdispatch` to keep its timers.
+Adding and cancelling a timer is O(1); every timer is moved down at most
+once per wheel level before it expires.
+
+Deadlines are measured in ticks of `resolution` nanoseconds. The finest wheel
+covers the next `wheelSize` ticks, each coarser wheel covers `wheelSize` times
+the range of the previous one, and deadlines beyond the coarsest wheel wait in
+an overflow list until the coarsest wheel wraps around.
+]##
+
+import std/[monotimes, times, options, bitops]
+
+const
+  wheelBits = 8
+  wheelSize = 1 shl wheelBits
+  wheelMask = wheelSize - 1
+  wheelLevels = 4 # 2^32 ticks, ~49 days at the default resolution
+  wheelWords = wheelSize div 64
+
+  notQueued = -1
+  dueLevel = wheelLevels
+  overflowLevel = wheelLevels + 1
+
+type
+  TimerEntry*[T] = ref object
+    ## A timer that has been added to a `TimerWheel`. Keep it around to
+    ## `cancel` the timer before it expires.
+    deadline: int64 # in ticks
+    level, slot, pos: int # location inside the wheel, for O(1) removal
+    data*: T
+
+  TimerWheel*[T] = object
+    resolution: int64 # length of a tick in nanoseconds
+    current: int64 # last tick that has been processed
+    count: int
+    due: seq[TimerEntry[T]] # deadline already reached when added
+    overflow: seq[TimerEntry[T]]
+    slots: array[wheelLevels, array[wheelSize, seq[TimerEntry[T]]]]
+    occupied: array[wheelLevels, array[wheelWords, uint64]]
+
+proc toTicks(resolution: int64; t: MonoTime): int64 {.inline.} =
+  t.ticks div resolution
+
+proc initTimerWheel*[T](resolution = initDuration(milliseconds = 1)): TimerWheel[T] =
+  ## Creates an empty timer wheel whose deadlines are rounded up to
+  ## multiples of `resolution`.
+  result = TimerWheel[T](resolution: max(resolution.inNanoseconds, 1))
+  result.current = toTicks(result.resolution, getMonoTime())
+
+proc len*[T](w: TimerWheel[T]): int {.inline.} =
+  ## Returns the number of pending timers.
+  w.count
+
+proc resolution*[T](w: TimerWheel[T]): Duration {.inline.} =
+  initDuration(nanoseconds = w.resolution)
+
+proc bucket[T](w: var TimerWheel[T]; level, slot: int): var seq[TimerEntry[T]] {.inline.} =
+  case level
+  of dueLevel: result = w.due
+  of overflowLevel: result = w.overflow
+  else: result = w.slots[level][slot]
+
+proc markSlot[T](w: var TimerWheel[T]; level, slot: int; occupied: bool) {.inline.} =
+  let bit = 1'u64 shl (slot and 63)
+  if occupied:
+    w.occupied[level][slot shr 6] = w.occupied[level][slot shr 6] or bit
+  else:
+    w.occupied[level][slot shr 6] = w.occupied[level][slot shr 6] and not bit
+
+proc append[T](list: var seq[TimerEntry[T]]; e: TimerEntry[T]) {.inline.} =
+  e.pos = list.len
+  list.add e
+
+proc remove[T](list: var seq[TimerEntry[T]]; e: TimerEntry[T]) {.inline.} =
+  let last = list.len - 1
+  if e.pos != last:
+    list[e.pos] = list[last]
+    list[e.pos].pos = e.pos
+  list.setLen(last)
+
+proc place[T](w: var TimerWheel[T]; e: TimerEntry[T]) =
+  let delta = e.deadline - w.current
+  e.slot = 0
+  if delta <= 0:
+    e.level = dueLevel
+  else:
+    e.level = overflowLevel
+    for level in 0 ..< wheelLevels:
+      if delta < (1'i64 shl (wheelBits * (level + 1))):
+        e.level = level
+        e.slot = int((e.deadline shr (wheelBits * level)) and int64(wheelMask))
+        break
+  w.bucket(e.level, e.slot).append(e)
+  if e.level < wheelLevels and e.pos == 0:
+    w.markSlot(e.level, e.slot, true)
+
+proc unlink[T](w: var TimerWheel[T]; e: TimerEntry[T]) =
+  w.bucket(e.level, e.slot).remove(e)
+  if e.level < wheelLevels and w.slots[e.level][e.slot].len == 0:
+    w.markSlot(e.level, e.slot, false)
+  e.level = notQueued
+
+proc add*[T](w: var TimerWheel[T]; finishAt: MonoTime; data: T): TimerEntry[T] {.discardable.} =
+  ## Adds a timer that expires at `finishAt`, rounded up to the resolution
+  ## of the wheel.
+  if w.count == 0:
+    # Nothing is pending, so the wheel can skip the idle period for free.
+    w.current = max(w.current, toTicks(w.resolution, getMonoTime()))
+  result = TimerEntry[T](data: data,
+    deadline: (finishAt.ticks + w.resolution - 1) div w.resolution)
+  w.place(result)
+  inc w.count
+
+proc push*[T](w: var TimerWheel[T]; timer: tuple[finishAt: MonoTime, data: T]) {.inline.} =
+  ## Same as `add`; kept so that code written against the former
+  ## `HeapQueue` of timers keeps compiling.
+  discard w.add(timer.finishAt, timer.data)
+
+proc isQueued*[T](e: TimerEntry[T]): bool {.inline.} =
+  ## Returns `true` if `e` has neither expired nor been cancelled.
+  e != nil and e.level != notQueued
+
+proc cancel*[T](w: var TimerWheel[T]; e: TimerEntry[T]) =
+  ## Removes `e` from the wheel. Does nothing if the timer has already
+  ## expired or been cancelled.
+  if e.isQueued:
+    w.unlink(e)
+    dec w.count
+
+proc clear*[T](w: var TimerWheel[T]) =
+  ## Drops every pending timer.
+  for level in 0 ..< wheelLevels:
+    for slot in 0 ..< wheelSize:
+      for e in w.slots[level][slot]: e.level = notQueued
+      w.slots[level][slot].setLen(0)
+    for word in mitems(w.occupied[level]): word = 0
+  for e in w.due: e.level = notQueued
+  for e in w.overflow: e.level = notQueued
+  w.due.setLen(0)
+  w.overflow.setLen(0)
+  w.count = 0
+
+proc cascade[T](w: var TimerWheel[T]; level: int) =
+  # Moves the timers of the slot of `level` that `current` just entered
+  # down to the finer wheels.
+  if level >= wheelLevels:
+    var pending = move w.overflow
+    for e in pending: w.place(e)
+    return
+  let slot = int((w.current shr (wheelBits * level)) and int64(wheelMask))
+  if slot == 0: w.cascade(level + 1)
+  if w.slots[level][slot].len > 0:
+    var pending = move w.slots[level][slot]
+    w.markSlot(level, slot, false)
+    for e in pending: w.place(e)
+
+proc isLevelEmpty[T](w: TimerWheel[T]; level: int): bool {.inline.} =
+  for word in w.occupied[level]:
+    if word != 0: return false
+  result = true
+
+proc collect[T](list: var seq[TimerEntry[T]]; expired: var seq[T]): int {.inline.} =
+  result = list.len
+  for e in list:
+    e.level = notQueued
+    expired.add e.data
+  list.setLen(0)
+
+proc advance*[T](w: var TimerWheel[T]; now: MonoTime; expired: var seq[T]) =
+  ## Removes every timer whose deadline is not after `now` and appends its
+  ## data to `expired`, ordered by deadline.
+  w.count -= collect(w.due, expired)
+  let target = toTicks(w.resolution, now)
+  while w.current < target:
+    if w.count == 0:
+      w.current = target
+      break
+    if w.isLevelEmpty(0):
+      # Nothing can expire before the next coarser slot is cascaded.
+      let boundary = (w.current or int64(wheelMask)) + 1
+      if boundary > target:
+        w.current = target
+        break
+      w.current = boundary
+    else:
+      inc w.current
+    let slot = int(w.current and int64(wheelMask))
+    if slot == 0: w.cascade(1)
+    if w.slots[0][slot].len > 0:
+      w.count -= collect(w.slots[0][slot], expired)
+      w.markSlot(0, slot, false)
+    w.count -= collect(w.due, expired)
+
+proc nextOccupied(bits: array[wheelWords, uint64]; start: int): int =
+  # Returns the distance from `start` to the first occupied slot, going
+  # around the wheel, or -1 if the wheel is empty.
+  let first = start shr 6
+  let low = (not 0'u64) shl (start and 63)
+  for i in 0 .. wheelWords:
+    let idx = (first + i) mod wheelWords
+    var word = bits[idx]
+    if i == 0: word = word and low
+    elif i == wheelWords: word = word and not low
+    if word != 0:
+      let slot = idx * 64 + countTrailingZeroBits(word)
+      return (slot - start + wheelSize) and wheelMask
+  result = -1
+
+proc nextTimeout*[T](w: TimerWheel[T]; now: MonoTime): Option[int] =
+  ## Returns the number of milliseconds until the next timer may expire,
+  ## or `none` if no timer is pending. The result never overestimates the
+  ## time left, but may underestimate it for timers on the coarser wheels.
+  if w.count == 0: return
+  if w.due.len > 0: return some(0)
+  var next = high(int64)
+  for level in 0 ..< wheelLevels:
+    let shift = wheelBits * level
+    let start = (w.current shr shift) + 1
+    let dist = nextOccupied(w.occupied[level], int(start and int64(wheelMask)))
+    if dist >= 0:
+      next = min(next, (start + int64(dist)) shl shift)
+  if w.overflow.len > 0:
+    let shift = wheelBits * wheelLevels
+    next = min(next, ((w.current shr shift) + 1) shl shift)
+  let ns = next * w.resolution - now.ticks
+  result = some(int(max(ns + 999_999, 0) div 1_000_000))
+
+proc `resolution=`*[T](w: var TimerWheel[T]; resolution: Duration) =
+  ## Changes the tick length of the wheel. Pending timers are kept, with
+  ## their deadlines rounded up to the new resolution.
+  let old = w.resolution
+  var pending: seq[TimerEntry[T]]
+  for level in 0 ..< wheelLevels:
+    for slot in 0 ..< wheelSize:
+      pending.add w.slots[level][slot]
+      w.slots[level][slot].setLen(0)
+    for word in mitems(w.occupied[level]): word = 0
+  pending.add w.due
+  pending.add w.overflow
+  w.due.setLen(0)
+  w.overflow.setLen(0)
+  w.resolution = max(resolution.inNanoseconds, 1)
+  w.current = toTicks(w.resolution, getMonoTime())
+  for e in pending:
+    e.deadline = (e.deadline * old + w.resolution - 1) div w.resolution
+    w.place(e)
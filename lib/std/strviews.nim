@@ -0,0 +1,314 @@
+#
+#
+#            Nim's Runtime Library
+#        (c) Copyright 2026 Nim contributors
+#
+#    See the file "copying.txt", included in this
+#    distribution, for details about the copyright.
+#
+
+## This module implements `StrView`, a pointer and a length that refer to
+## characters owned by something else, like `memfiles.MemSlice` does for
+## memory mapped files. The split iterators of this module yield views into
+## their input instead of a new `string` per field, and the usual parsing,
+## comparison and hashing procs accept views, so that whole pipelines over
+## CSV, TSV or log files can run without allocating per field.
+##
+## A view is only valid while the memory it refers to is alive and does not
+## move: a view into a `string` must not outlive the string, and the string
+## must not grow while the view is used. Views are not available for the JS
+## backend and at compile time.
+runnableExamples:
+  let line = "alice,42,3.5"
+  var fields: seq[StrView]
+  for f in line.splitView(','):
+    fields.add f
+  assert fields.len == 3
+  assert fields[0] == "alice"
+  assert parseInt(fields[1]) == 42
+  assert parseFloat(fields[2]) == 3.5
+  assert $fields[0] == "alice"
+
+## See also
+## ========
+## * `strutils module <strutils.html>`_ for the split procs that return strings
+## * `memfiles module <memfiles.html>`_ for `MemSlice`
+
+import std/[hashes, parseutils]
+
+when defined(nimPreviewSlimSystem):
+  import std/assertions
+
+const Whitespace = {' ', '\t', '\v', '\r', '\l', '\f'}
+
+type
+  StrView* = object ## A view into characters that are owned elsewhere.
+    data*: ptr UncheckedArray[char]
+    size*: int
+
+when not (defined(js) or defined(nimscript)):
+  func c_memchr(cstr: pointer, c: char, n: csize_t): pointer {.
+                importc: "memchr", header: "<string.h>".}
+
+func toStrView*(data: pointer, size: int): StrView {.inline.} =
+  ## Returns a view of the `size` characters at `data`.
+  StrView(data: cast[ptr UncheckedArray[char]](data), size: size)
+
+func toStrView*(s: openArray[char]): StrView {.inline.} =
+  ## Returns a view of the characters of `s`, which must outlive the view.
+  if s.len > 0:
+    result = StrView(data: cast[ptr UncheckedArray[char]](unsafeAddr s[0]), size: s.len)
+
+func viewOf(s: openArray[char], first, last: int): StrView {.inline.} =
+  # the view of `s[first..last]`, which may be empty
+  if first <= last:
+    result = StrView(data: cast[ptr UncheckedArray[char]](unsafeAddr s[first]),
+                     size: last - first + 1)
+
+template toOpenArray*(v: StrView): untyped =
+  ## Returns the characters of `v` as an `openArray`.
+  toOpenArray(v.data, 0, v.size - 1)
+
+func len*(v: StrView): int {.inline.} =
+  ## Returns the number of characters in `v`.
+  v.size
+
+func checkIndex(v: StrView, i: int) {.inline.} =
+  when compileOption("boundChecks"):
+    if i < 0 or i >= v.size:
+      raise newException(IndexDefect, "index " & $i & " not in 0 .. " & $(v.size - 1))
+
+func `[]`*(v: StrView, i: int): char {.inline.} =
+  ## Returns the character at index `i` of `v`.
+  checkIndex(v, i)
+  v.data[i]
+
+func `[]`*(v: StrView, i: BackwardsIndex): char {.inline.} =
+  ## Returns the character at index `v.len - int(i)` of `v`.
+  v[v.size - int(i)]
+
+func `[]`*[T, U: Ordinal](v: StrView, x: HSlice[T, U]): StrView =
+  ## Returns the view of the characters of `v` in the range `x`.
+  runnableExamples:
+    let v = toStrView("hello world")
+    assert v[6 .. ^1] == "world"
+  let a = v ^^ x.a
+  let b = v ^^ x.b
+  if b < a: return
+  checkIndex(v, a)
+  checkIndex(v, b)
+  result = StrView(data: cast[ptr UncheckedArray[char]](addr v.data[a]), size: b - a + 1)
+
+iterator items*(v: StrView): char =
+  ## Iterates over the characters of `v`.
+  for i in 0 ..< v.size: yield v.data[i]
+
+iterator pairs*(v: StrView): tuple[key: int, val: char] =
+  ## Iterates over the indexes and characters of `v`.
+  for i in 0 ..< v.size: yield (i, v.data[i])
+
+func `$`*(v: StrView): string =
+  ## Returns a copy of the characters of `v` as a string.
+  result = newString(v.size)
+  if v.size > 0:
+    copyMem(addr result[0], v.data, v.size)
+
+func add*(s: var string, v: StrView) =
+  ## Appends the characters of `v` to `s`.
+  if v.size > 0:
+    let L = s.len
+    s.setLen(L + v.size)
+    copyMem(addr s[L], v.data, v.size)
+
+func cmp*(a: StrView, b: openArray[char]): int =
+  ## Compares `a` and `b` by their bytes, like `system.cmp` for strings.
+  let n = min(a.size, b.len)
+  if n > 0:
+    result = cmpMem(a.data, unsafeAddr b[0], n)
+    if result != 0: return
+  result = a.size - b.len
+
+func cmp*(a, b: StrView): int {.inline.} =
+  ## Compares `a` and `b` by their bytes, like `system.cmp` for strings.
+  cmp(a, toOpenArray(b))
+
+func `==`*(a: StrView, b: openArray[char]): bool =
+  ## Returns true if `a` and `b` contain the same characters.
+  a.size == b.len and (a.size == 0 or equalMem(a.data, unsafeAddr b[0], a.size))
+
+func `==`*(a: openArray[char], b: StrView): bool {.inline.} = b == a
+
+func `==`*(a, b: StrView): bool {.inline.} = a == toOpenArray(b)
+
+func `<`*(a, b: StrView): bool {.inline.} = cmp(a, b) < 0
+
+func `<=`*(a, b: StrView): bool {.inline.} = cmp(a, b) <= 0
+
+func hash*(v: StrView): Hash =
+  ## Returns the same hash as `hash` for a string with the characters of `v`.
+  runnableExamples:
+    import std/hashes
+    assert hash(toStrView("key")) == hash("key")
+  hash(toOpenArray(v))
+
+func startsWith*(v: StrView, prefix: openArray[char]): bool =
+  ## Returns true if `v` starts with `prefix`.
+  prefix.len <= v.size and v[0 ..< prefix.len] == prefix
+
+func endsWith*(v: StrView, suffix: openArray[char]): bool =
+  ## Returns true if `v` ends with `suffix`.
+  suffix.len <= v.size and v[v.size - suffix.len .. ^1] == suffix
+
+func strip*(v: StrView, leading = true, trailing = true,
+            chars: set[char] = Whitespace): StrView =
+  ## Returns the view of `v` without the leading and trailing `chars`.
+  runnableExamples:
+    assert toStrView("  x y\t").strip == "x y"
+  var a = 0
+  var b = v.size - 1
+  if leading:
+    while a <= b and v.data[a] in chars: inc a
+  if trailing:
+    while b >= a and v.data[b] in chars: dec b
+  result = if a <= b: v[a .. b] else: StrView()
+
+func parseInt*(v: StrView): int =
+  ## Parses a decimal integer value contained in `v`.
+  ##
+  ## If `v` is not a valid integer, `ValueError` is raised.
+  let L = parseutils.parseInt(toOpenArray(v), result)
+  if L != v.size or L == 0:
+    raise newException(ValueError, "invalid integer: " & $v)
+
+func parseBiggestInt*(v: StrView): BiggestInt =
+  ## Parses a decimal integer value contained in `v`.
+  ##
+  ## If `v` is not a valid integer, `ValueError` is raised.
+  let L = parseutils.parseBiggestInt(toOpenArray(v), result)
+  if L != v.size or L == 0:
+    raise newException(ValueError, "invalid integer: " & $v)
+
+func parseUInt*(v: StrView): uint =
+  ## Parses a decimal unsigned integer value contained in `v`.
+  ##
+  ## If `v` is not a valid unsigned integer, `ValueError` is raised.
+  let L = parseutils.parseUInt(toOpenArray(v), result)
+  if L != v.size or L == 0:
+    raise newException(ValueError, "invalid unsigned integer: " & $v)
+
+func parseFloat*(v: StrView): float =
+  ## Parses a decimal floating point value contained in `v`.
+  ##
+  ## If `v` is not a valid floating point number, `ValueError` is raised.
+  ## `NAN`, `INF`, `-INF` are also supported (case insensitive comparison).
+  let L = parseutils.parseFloat(toOpenArray(v), result)
+  if L != v.size or L == 0:
+    raise newException(ValueError, "invalid float: " & $v)
+
+func findSep(s: openArray[char], sep: char, start: int): int {.inline.} =
+  # the position of the next `sep` at or after `start`, or `s.len`
+  when declared(c_memchr):
+    if start < s.len:
+      let found = c_memchr(unsafeAddr s[start], sep, csize_t(s.len - start))
+      return if found.isNil: s.len else: cast[int](found) -% cast[int](unsafeAddr s[0])
+    result = s.len
+  else:
+    result = start
+    while result < s.len and s[result] != sep: inc result
+
+func findSep(s: openArray[char], seps: set[char], start: int): int {.inline.} =
+  result = start
+  while result < s.len and s[result] notin seps: inc result
+
+func findSep(s: openArray[char], sep: string, start: int): int {.inline.} =
+  result = start
+  while result <= s.len - sep.len:
+    if s[result] == sep[0] and viewOf(s, result, result + sep.len - 1) == sep:
+      return
+    inc result
+  result = s.len
+
+template splitImpl(s, sep, maxsplit, sepLen) =
+  var last = 0
+  var splits = maxsplit
+  while last <= s.len:
+    let first = last
+    last = findSep(s, sep, last)
+    if splits == 0: last = s.len
+    yield viewOf(s, first, last - 1)
+    if splits == 0: break
+    dec(splits)
+    inc(last, sepLen)
+
+iterator splitView*(s: openArray[char], sep: char, maxsplit: int = -1): StrView =
+  ## Like `strutils.split` for a single separator, but yields views into
+  ## `s` instead of new strings.
+  runnableExamples:
+    var fields: seq[string]
+    for f in splitView(";;a;b", ';'):
+      fields.add $f
+    assert fields == @["", "", "a", "b"]
+  splitImpl(s, sep, maxsplit, 1)
+
+iterator splitView*(s: openArray[char], seps: set[char] = Whitespace,
+                    maxsplit: int = -1): StrView =
+  ## Like `strutils.split` for a group of separators, but yields views into
+  ## `s` instead of new strings.
+  splitImpl(s, seps, maxsplit, 1)
+
+iterator splitView*(s: openArray[char], sep: string, maxsplit: int = -1): StrView =
+  ## Like `strutils.split` for a string separator, but yields views into
+  ## `s` instead of new strings.
+  runnableExamples:
+    var fields: seq[string]
+    for f in splitView("a::b::", "::"):
+      fields.add $f
+    assert fields == @["a", "b", ""]
+  assert sep.len > 0
+  splitImpl(s, sep, maxsplit, sep.len)
+
+iterator splitWhitespaceView*(s: openArray[char], maxsplit: int = -1): StrView =
+  ## Like `strutils.splitWhitespace`, but yields views into `s` instead of
+  ## new strings.
+  runnableExamples:
+    var words: seq[string]
+    for w in splitWhitespaceView("  a b\t\tc "):
+      words.add $w
+    assert words == @["a", "b", "c"]
+  var last = 0
+  var splits = maxsplit
+  while last < s.len:
+    while last < s.len and s[last] in Whitespace: inc(last)
+    let first = last
+    while last < s.len and s[last] notin Whitespace: inc(last)
+    if first <= last - 1:
+      if splits == 0: last = s.len
+      yield viewOf(s, first, last - 1)
+      if splits == 0: break
+      dec(splits)
+
+iterator splitLinesView*(s: openArray[char], keepEol = false): StrView =
+  ## Like `strutils.splitLines`, but yields views into `s` instead of new
+  ## strings.
+  runnableExamples:
+    var lines: seq[string]
+    for line in splitLinesView("a\r\nb\n\nc"):
+      lines.add $line
+    assert lines == @["a", "b", "", "c"]
+  var first = 0
+  var last = 0
+  while true:
+    # `memchr` finds the LF, then only the line itself is checked for a CR
+    let lf = findSep(s, '\l', first)
+    last = findSep(toOpenArray(s, 0, lf - 1), {'\c'}, first)
+    let eolpos = last
+    if last < s.len:
+      if s[last] == '\l': inc(last)
+      else:
+        inc(last)
+        if last < s.len and s[last] == '\l': inc(last)
+    yield viewOf(s, first, if keepEol: last - 1 else: eolpos - 1)
+    # no eol characters consumed means that the input is over
+    if eolpos == last:
+      break
+    first = last
@@ -739,6 +739,9 @@ proc processCategory(r: var TResults, cat: Category,
       for file in walkDirRec(testsDir &.? cat.string):
         if isTestFile(file): files.add file
       files.sort # give reproducible order
+      if testamentData0.testamentNumShards > 0:
+        testamentData0.shardOf = assignShards(cat.string, files,
+          testamentData0.testamentNumShards, testamentData0.shardTimesDir)
       for i, name in files:
         var test = makeTest(name, options, cat)
         if runJoinableTests or not isJoinableSpec(test.spec) or cat.string in specialCategories:
@@ -10,12 +10,18 @@
 import sequtils, parseutils, strutils, os, streams, parsecfg,
   tables, hashes, sets
 import compiler/platform
+from testcache import shardByName
 
 type TestamentData* = ref object
   # better to group globals under 1 object; could group the other ones here too
   batchArg*: string
   testamentNumBatch*: int
   testamentBatch*: int
+  testamentNumShards*: int
+  testamentShard*: int
+  shardTimesDir*: string
+  shardOf*: Table[string, int]
+    # shard of the test files of the current category, see `assignShards`
 
 let testamentData0* = TestamentData()
 
@@ -313,6 +319,10 @@ proc initSpec*(filename: string): TSpec =
 proc isCurrentBatch*(testamentData: TestamentData; filename: string): bool =
   if testamentData.testamentNumBatch != 0:
     hash(filename) mod testamentData.testamentNumBatch == testamentData.testamentBatch
+  elif testamentData.testamentNumShards != 0:
+    let shard = testamentData.shardOf.getOrDefault(filename,
+      shardByName(filename, testamentData.testamentNumShards))
+    shard == testamentData.testamentShard
   else:
     true
 
@@ -14,7 +14,7 @@ import
     parseopt, browsers, terminal, exitprocs,
     algorithm, times, intsets, macros]
 
-import backend, specs, azure, htmlgen
+import backend, specs, azure, htmlgen, testcache
 
 from std/sugar import dup
 import compiler/nodejs
@@ -35,6 +35,7 @@ var simulate = false
 var optVerbose = false
 var useMegatest = true
 var valgrindEnabled = true
+var useCache = false
 
 proc verboseCmd(cmd: string) =
   if optVerbose:
@@ -68,6 +69,18 @@ Options:
   --megatest:on|off         Enable or disable megatest. Default is on.
   --valgrind:on|off         Enable or disable valgrind support. Default is on.
   --skipFrom:file           Read tests to skip from `file` - one test per line, # comments ignored
+  --cache:on|off            Don't run tests again whose compiler, C compiler, modules,
+                            configuration and neighbouring files are unchanged since they
+                            last passed. Only C, C++ and Objective-C tests are cached.
+                            Files a test reads at compile time are not tracked, so a
+                            fresh run is still needed before a release. Default is off.
+  --shard:i/n               Only run the i-th (0 based) of n shards of the tests.
+  --shardTimes:dir          Split the shards by the durations in `dir`, a copy of
+                            testresults/cache/ that every shard has to be given, so that
+                            they take about the same time. Otherwise by file name.
+
+The durations and the results of the tests are recorded in testresults/cache/. `all`
+starts the categories that took the longest first.
 
 On Azure Pipelines, testament will also publish test results via Azure Pipelines' Test Management API
 provided that System.AccessToken is made available via the environment variable SYSTEM_ACCESSTOKEN.
@@ -165,6 +178,7 @@ proc prepareTestCmd(cmdTemplate, filename, options, nimcache: string,
                      target: TTarget, extraOptions = ""): string =
   var options = target.defaultOptions & ' ' & options
   if nimcache.len > 0: options.add(" --nimCache:$#" % nimcache.quoteShell)
+  if useCache: options.add " -d:nimWriteDepsFile" # see `readDeps`
   options.add ' ' & extraOptions
   # we avoid using `parseCmdLine` which is buggy, refs bug #14343
   result = cmdTemplate % ["target", targetToCmd[target],
@@ -274,6 +288,9 @@ proc testName(test: TTest, target: TTarget, extraOptions: string, allowFailure:
   if extraOptions.len > 0: name.add ' ' & extraOptions
   name.strip()
 
+proc testOptions(test: TTest, target: TTarget, extraOptions: string): string =
+  result = test.options & ' ' & $target & ' ' & extraOptions
+
 proc addResult(r: var TResults, test: TTest, target: TTarget,
                extraOptions, expected, given: string, success: TResultEnum, duration: float,
                allowFailure = false, givenSpec: ptr TSpec = nil) =
@@ -283,6 +300,18 @@ proc addResult(r: var TResults, test: TTest, target: TTarget,
   # A bit hacky but simple and works with tests/testament/tshould_not_work.nim
   let name = testName(test, target, extraOptions, allowFailure)
 
+  if success notin {reDisabled, reJoined}:
+    var cached = CachedTest(file: test.name, duration: duration)
+    if useCache and success == reSuccess and "(cached) " notin test.debugInfo:
+      (cached.deps, cached.cc) = readDeps(
+        nimcacheDir(test.name, test.options, target), test.name)
+      cached.inputs = inputsHash(compilerPrefix,
+        testOptions(test, target, extraOptions), cached)
+    elif success == reSuccess:
+      cached = cachedTest(test.cat.string, testName(test, target, extraOptions, false))
+      cached.duration = duration
+    recordTest(test.cat.string, testName(test, target, extraOptions, false), cached)
+
   let durationStr = duration.formatFloat(ffDecimal, precision = 2).align(5)
   if backendLogging:
     backend.writeTestResult(name = name,
@@ -501,6 +530,14 @@ proc testSpecHelper(r: var TResults, test: var TTest, expected: TSpec,
     r.finishTest(test, target, extraOptions, "", "", test.spec.err)
     inc(r.skipped)
     return
+  if useCache and test.spec.err != reRetry:
+    let cached = cachedTest(test.cat.string, testName(test, target, extraOptions, false))
+    if cached.inputs.len > 0 and cached.inputs == inputsHash(compilerPrefix,
+        testOptions(test, target, extraOptions), cached):
+      test.debugInfo.add "(cached) "
+      r.addResult(test, target, extraOptions, "", "", reSuccess, cached.duration)
+      inc(r.passed)
+      return
   var given = callNimCompiler(expected.getCmd, test.name, test.options, nimcache, target, extraOptions)
   case expected.action
   of actionCompile:
@@ -746,6 +783,27 @@ proc main() =
         quit Usage
     of "skipfrom":
       skipFrom = p.val
+    of "cache":
+      case p.val:
+      of "on":
+        useCache = true
+      of "off":
+        useCache = false
+      else:
+        quit Usage
+    of "shard":
+      let s = p.val.split("/")
+      if s.len != 2: quit Usage
+      try:
+        testamentData0.testamentShard = s[0].parseInt
+        testamentData0.testamentNumShards = s[1].parseInt
+      except ValueError:
+        quit Usage
+      if testamentData0.testamentNumShards <= 0 or testamentData0.testamentShard notin
+          0..<testamentData0.testamentNumShards:
+        quit Usage
+    of "shardtimes":
+      testamentData0.shardTimesDir = p.val
     else:
       quit Usage
     p.next()
@@ -768,6 +826,13 @@ proc main() =
 
     if skipFrom.len > 0:
       myself &= " " & quoteShell("--skipFrom:" & skipFrom)
+    if useCache:
+      myself &= " --cache:on"
+    if testamentData0.testamentNumShards > 0:
+      myself &= " --shard:$1/$2" % [$testamentData0.testamentShard,
+                                    $testamentData0.testamentNumShards]
+    if testamentData0.shardTimesDir.len > 0:
+      myself &= " " & quoteShell("--shardTimes:" & testamentData0.shardTimesDir)
 
     var cats: seq[string]
     let rest = if p.cmdLineRest.len > 0: " " & p.cmdLineRest else: ""
@@ -779,6 +844,14 @@ proc main() =
     if isNimRepoTests():
       cats.add AdditionalCategories
     if useMegatest: cats.add MegaTestCat
+    # longest first, so that the long categories don't start last
+    var byDuration: seq[(float, string)] = @[]
+    for cat in cats: byDuration.add (categoryDuration(cat), cat)
+    byDuration.sort(proc (a, b: (float, string)): int =
+      result = cmp(b[0], a[0])
+      if result == 0: result = cmp(a[1], b[1]))
+    cats.setLen 0
+    for (_, cat) in byDuration: cats.add cat
 
     var cmds: seq[string]
     for cat in cats:
@@ -827,6 +900,7 @@ proc main() =
     else: echo r, r.data
   azure.finalize()
   backend.close()
+  saveTestCaches()
   var failed = r.total - r.passed - r.skipped
   if failed != 0:
     echo "FAILURE! total: ", r.total, " passed: ", r.passed, " skipped: ",
@@ -0,0 +1,181 @@
+#
+#
+#              The Nim Tester
+#        (c) Copyright 2026 Nim contributors
+#
+#    Look at license.txt for more info.
+#    All rights reserved.
+
+## Remembers for every test how long it took and, if it passed, its inputs
+## and a hash of them, in `testresults/cache/<category>.json`. Testament uses
+## this to skip tests whose inputs did not change (`--cache:on`) and to start
+## the longest categories first. `--shard:i/n` splits the tests into shards of
+## about the same time by the durations of such a directory that all shards
+## are given (`--shardTimes:dir`).
+
+import std/[os, osproc, json, tables, algorithm, strutils, hashes]
+import ../dist/checksums/src/checksums/md5
+
+type
+  CachedTest* = object
+    file*: string       ## the test file
+    inputs*: string     ## hash of the inputs of the last run if it passed
+    deps*: seq[string]  ## the modules and includes the compiler read
+    cc*: string         ## the C compiler, "" for other backends
+    duration*: float    ## duration of the last run in seconds
+
+  TestCache = object
+    tests: Table[string, CachedTest]
+    changed: bool
+
+const cacheDir = "testresults" / "cache"
+
+var
+  caches: Table[string, TestCache] # by category
+  fileHashes: Table[string, string]
+  versions: Table[string, string]  # of the C compilers
+
+proc cacheFile(cat: string; dir = cacheDir): string =
+  dir / cat.replace(DirSep, '_').replace('/', '_').addFileExt("json")
+
+proc load(cat: string; dir = cacheDir): TestCache =
+  result = TestCache()
+  let file = cacheFile(cat, dir)
+  if fileExists(file):
+    try:
+      for name, t in parseFile(file):
+        var deps: seq[string] = @[]
+        for d in t{"deps"}.getElems: deps.add d.getStr
+        result.tests[name] = CachedTest(file: t{"file"}.getStr,
+          inputs: t{"inputs"}.getStr, deps: deps, cc: t{"cc"}.getStr,
+          duration: t{"duration"}.getFloat)
+    except CatchableError:
+      discard "a broken cache is as good as none"
+
+proc cacheOf(cat: string): var TestCache =
+  if not caches.hasKey(cat): caches[cat] = load(cat)
+  caches[cat]
+
+proc cachedTest*(cat, name: string): CachedTest =
+  result = cacheOf(cat).tests.getOrDefault(name)
+
+proc recordTest*(cat, name: string; test: CachedTest) =
+  cacheOf(cat).tests[name] = test
+  cacheOf(cat).changed = true
+
+proc saveTestCaches*() =
+  for cat, c in caches:
+    if c.changed:
+      var names: seq[string] = @[]
+      for name in c.tests.keys: names.add name
+      names.sort
+      var j = newJObject()
+      for name in names:
+        let t = c.tests[name]
+        j[name] = %*{"file": t.file, "inputs": t.inputs, "deps": t.deps,
+                     "cc": t.cc, "duration": t.duration}
+      try:
+        createDir(cacheDir)
+        writeFile(cacheFile(cat), j.pretty)
+      except OSError, IOError:
+        echo "cannot write the test cache: ", getCurrentExceptionMsg()
+
+proc categoryDuration*(cat: string): float =
+  ## The recorded duration of all tests of `cat`, `Inf` if there is none.
+  let c = load(cat)
+  if c.tests.len == 0: return Inf
+  result = 0.0
+  for t in c.tests.values: result += t.duration
+
+proc shardByName*(file: string; n: int): int =
+  ## The shard of `file` if there are no durations to go by.
+  result = (hash(file) and high(int)) mod n
+
+proc assignShards*(cat: string; files: seq[string]; n: int;
+                   timesDir: string): Table[string, int] =
+  ## Splits `files` into `n` shards of about the same duration, by giving the
+  ## longest remaining test to the shard with the least work so far. The
+  ## durations are read from `timesDir`, a copy of `testresults/cache` that
+  ## all shards must be given, so that they agree on the partition; files
+  ## without a duration there count as an average test. Without `timesDir`
+  ## the files are split by `shardByName`.
+  result = initTable[string, int]()
+  if timesDir.len == 0:
+    for f in files: result[f] = shardByName(f, n)
+    return
+  var durations = initTable[string, float]()
+  for t in load(cat, timesDir).tests.values:
+    durations.mgetOrPut(t.file, 0.0) += t.duration
+  var mean = 1.0
+  if durations.len > 0:
+    mean = 0.0
+    for d in durations.values: mean += d
+    mean /= durations.len.float
+  var order: seq[(float, string)] = @[]
+  for f in files: order.add (durations.getOrDefault(f, mean), f)
+  order.sort(proc (a, b: (float, string)): int =
+    result = cmp(b[0], a[0])
+    if result == 0: result = cmp(a[1], b[1]))
+  var work = newSeq[float](n)
+  for (d, f) in order:
+    var shard = 0
+    for i in 1..<n:
+      if work[i] < work[shard]: shard = i
+    work[shard] += d
+    result[f] = shard
+
+proc hashFile(file: string): string =
+  result = fileHashes.getOrDefault(file)
+  if result.len == 0:
+    result = try: getMD5(readFile(file)) except IOError: "-"
+    fileHashes[file] = result
+
+proc ccVersion(cc: string): string =
+  if cc.len == 0: return ""
+  result = versions.getOrDefault(cc)
+  if result.len == 0:
+    result = try: execCmdEx(quoteShell(cc) & " --version").output
+             except OSError: "-"
+    versions[cc] = result
+
+proc readDeps*(nimcache, file: string): tuple[deps: seq[string], cc: string] =
+  ## The modules and includes of the test `file` as the compiler listed them
+  ## in `nimcache` with `-d:nimWriteDepsFile`, and the C compiler of its link
+  ## command. No `deps` if the compiler did not list them.
+  result = (@[], "")
+  let depsFile = nimcache / file.splitFile.name & ".deps"
+  if not fileExists(depsFile): return
+  for line in lines(depsFile):
+    if line.len > 0: result.deps.add line
+  result.deps.sort
+  for f in walkFiles(nimcache / "*.json"):
+    try:
+      let link = parseFile(f){"linkcmd"}.getStr
+      if link.len > 0:
+        result.cc = parseCmdLine(link)[0]
+        break
+    except CatchableError:
+      discard
+
+proc inputsHash*(compiler, options: string; test: CachedTest): string =
+  ## Hash of what `test` depends on with `options`: the compiler and the C
+  ## compiler, the modules and includes of the program, the configuration of
+  ## its directory and the directories above, and the other files of its
+  ## directory, which it may read at run time. "" if its modules are unknown.
+  if test.deps.len == 0: return ""
+  let nim = if fileExists(compiler): compiler else: findExe(compiler)
+  var s = hashFile(nim) & options & ccVersion(test.cc)
+  for f in test.deps: s.add f & hashFile(f)
+  let dir = test.file.parentDir
+  var files: seq[string] = @[]
+  for kind, f in walkDir(dir):
+    if kind == pcFile and f.splitFile.ext != ".nim": files.add f
+  files.sort
+  for f in files: s.add f & hashFile(f)
+  var parent = dir
+  while parent.len > 0:
+    for cfg in ["config.nims", "nim.cfg"]:
+      if fileExists(parent / cfg): s.add hashFile(parent / cfg)
+    if parent == parent.parentDir: break
+    parent = parent.parentDir
+  result = getMD5(s)
@@ -0,0 +1,62 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+"""
+
+# async procs without `await` run without a closure iterator; they have to
+# behave like the ones that have one
+
+import std/asyncdispatch
+import std/assertions
+
+proc value(x: int): Future[int] {.async.} =
+  if x < 0:
+    return -x
+  result = x
+
+proc finallyReturn(log: ref seq[string]): Future[string] {.async.} =
+  try:
+    if true:
+      return "early"
+    log[].add "unreachable"
+  finally:
+    log[].add "finally"
+
+proc fails(msg: string) {.async.} =
+  if msg.len > 0:
+    raise newException(ValueError, msg)
+
+proc defaults(a: int, b = 2, c: string = "c"): Future[string] {.async.} =
+  result = $a & $b & c
+
+proc completeVar(fut: FutureVar[string]) {.async.} =
+  fut.mget() = "done"
+
+template hiddenAwait(f: untyped): untyped = await f
+
+proc hidden(): Future[int] {.async.} =
+  # the `await` is only visible after the template is expanded
+  result = hiddenAwait(value(5)) + 1
+
+proc main() {.async.} =
+  doAssert (await value(3)) == 3
+  doAssert (await value(-4)) == 4
+
+  let log = new seq[string]
+  doAssert (await finallyReturn(log)) == "early"
+  doAssert log[] == @["finally"]
+
+  let f = fails("boom")
+  doAssert f.finished and f.failed
+  doAssert f.error.msg == "boom"
+  await fails("")
+
+  doAssert (await defaults(1)) == "12c"
+  doAssert (await defaults(1, 3, "d")) == "13d"
+
+  let fv = newFutureVar[string]()
+  await completeVar(fv)
+  doAssert fv.finished and fv.read() == "done"
+
+  doAssert (await hidden()) == 6
+
+waitFor main()
@@ -0,0 +1,44 @@
+discard """
+output: '''
+1000
+1000
+'''
+"""
+
+import std/[asyncdispatch, asyncnet]
+import std/assertions
+
+const writeBufferPort = Port(6048)
+
+proc readLines(client: AsyncSocket, count: int): Future[int] {.async.} =
+  while result < count:
+    let line = await client.recvLine()
+    if line.len == 0: break
+    doAssert line == "frame " & $result, line
+    inc result
+
+proc testPipeline(highWaterMark: int): Future[void] {.async.} =
+  let server = newAsyncSocket()
+  server.setSockOpt(OptReuseAddr, true)
+  server.bindAddr(writeBufferPort)
+  server.listen()
+  let acceptFut = server.accept()
+
+  let client = newAsyncSocket()
+  await client.connect("localhost", writeBufferPort)
+  let peer = await acceptFut
+  let readFut = readLines(peer, 1000)
+
+  client.setWriteBuffer(highWaterMark)
+  for i in 0 ..< 1000:
+    await client.send("frame " & $i & "\c\L")
+  await client.flush()
+
+  echo await readFut
+  client.close()
+  peer.close()
+  server.close()
+
+waitFor testPipeline(64 * 1024)
+# a tiny high-water mark makes `send` flush all the time
+waitFor testPipeline(16)
@@ -0,0 +1,63 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+"""
+
+import std/[asyncdispatch, times]
+import std/assertions
+
+proc worker(n: int) {.async.} =
+  for i in 0 ..< n:
+    await sleepAsync(1)
+
+block:
+  let disp = getGlobalDispatcher()
+  disp.resetMetrics()
+  var m = disp.metrics
+  doAssert m.ticks == 0
+  doAssert m.timersFired == 0
+  doAssert m.batchSize > 0
+
+  let fut = worker(5)
+  m = disp.metrics
+  doAssert m.pendingTimers == 1
+  waitFor fut
+
+  m = disp.metrics
+  doAssert m.ticks >= 5
+  doAssert m.timersFired == 5
+  doAssert m.callbacksRun >= 5
+  doAssert m.pendingTimers == 0
+  doAssert m.pendingCallbacks == 0
+  doAssert m.busyTime >= DurationZero
+  doAssert m.maxTickEvents >= m.lastTickEvents
+
+  when not defined(windows):
+    let ev = newAsyncEvent()
+    var fired = false
+    addEvent(ev, proc (fd: AsyncFD): bool =
+      fired = true
+      true)
+    ev.trigger()
+    let before = disp.metrics.events
+    poll()
+    doAssert fired
+    doAssert disp.metrics.events > before
+    ev.close()
+
+    # the batch grows while the selector fills it, and shrinks when idle
+    let initial = disp.metrics.batchSize
+    var events: seq[AsyncEvent]
+    var count = 0
+    for i in 0 ..< 2 * initial:
+      events.add newAsyncEvent()
+      addEvent(events[^1], proc (fd: AsyncFD): bool =
+        inc count
+        true)
+    for ev in events: ev.trigger()
+    while count < events.len: poll()
+    doAssert disp.metrics.batchSize > initial
+    for ev in events: ev.close()
+    for i in 0 ..< 1000:
+      callSoon(proc () = discard)
+      poll(0)
+    doAssert disp.metrics.batchSize == initial
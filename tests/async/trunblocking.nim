@@ -0,0 +1,96 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+"""
+
+import std/[asyncdispatch, asyncfile, os, strutils]
+import std/assertions
+
+var running, overlapped: int
+
+proc slowDouble(arg: pointer): int {.nimcall, gcsafe.} =
+  if atomicInc(running) > 1: atomicInc(overlapped)
+  sleep(100)
+  atomicDec(running)
+  result = 2 * cast[ptr int](arg)[]
+
+proc blockingJobs() =
+  # jobs run on the worker threads while the loop keeps going
+  var args = [1, 2, 3, 4]
+  var futs: seq[Future[int]]
+  for i in 0 ..< args.len:
+    futs.add runBlocking(slowDouble, addr args[i])
+  var timerRanWhilePending = false
+  addTimer(10, true, proc (fd: AsyncFD): bool =
+    timerRanWhilePending = not futs[0].finished
+    result = true)
+  while not futs[^1].finished:
+    poll(10)
+  for i in 0 ..< args.len:
+    doAssert waitFor(futs[i]) == 2 * args[i]
+  doAssert timerRanWhilePending
+  when asyncBlockingThreads >= 4:
+    doAssert overlapped > 0
+  # the pool does not keep the dispatcher busy once it is idle
+  doAssert not hasPendingOperations()
+
+blockingJobs()
+
+proc fileRoundTrip() {.async.} =
+  let fn = getTempDir() / "trunblocking.txt"
+  var file = openAsync(fn, fmWrite)
+  # writes issued back to back end up in order
+  let a = file.write("first line\c\L")
+  let b = file.write("second line\L")
+  await a
+  await b
+  await file.write("third")
+  doAssert file.getFilePos() == 28
+  doAssert file.getFileSize() == 28
+  file.close()
+
+  file = openAsync(fn, fmRead)
+  doAssert (await file.readLine()) == "first line"
+  doAssert (await file.readLine()) == "second line"
+  doAssert file.getFilePos() == 23
+  doAssert (await file.readLine()) == "third"
+  doAssert (await file.readLine()) == ""
+  file.setFilePos(6)
+  doAssert (await file.read(4)) == "line"
+  file.close()
+  removeFile(fn)
+
+waitFor fileRoundTrip()
+
+proc concurrentAppends() {.async.} =
+  let fn = getTempDir() / "trunblocking_append.txt"
+  removeFile(fn)
+  var file = openAsync(fn, fmAppend)
+  var writes: seq[Future[void]]
+  var expected = ""
+  for i in 0 ..< 200:
+    let line = "line " & $i & repeat('.', i mod 37) & "\n"
+    writes.add file.write(line)
+    expected.add line
+  await all(writes)
+  file.close()
+  doAssert readFile(fn) == expected
+  removeFile(fn)
+
+waitFor concurrentAppends()
+
+proc closeWhilePending() {.async.} =
+  # `close` waits for the writes that are still on the worker threads
+  let fn = getTempDir() / "trunblocking_close.txt"
+  var file = openAsync(fn, fmWrite)
+  let data = repeat('x', 1 shl 20)
+  let a = file.write(data)
+  let b = file.write("end")
+  file.close()
+  when compileOption("threads"):
+    doAssert not b.finished
+  await a
+  await b
+  doAssert readFile(fn) == data & "end"
+  removeFile(fn)
+
+waitFor closeWhilePending()
@@ -0,0 +1,72 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+"""
+
+import std/[asyncdispatch, monotimes, times, options, sequtils]
+import std/private/timerwheel
+import std/assertions
+
+block: # expiry order across wheel levels
+  var w = initTimerWheel[int]()
+  let start = getMonoTime()
+  for ms in [70_000, 5, 300, 0, 1, 255, 256, 65_536, 20_000_000]:
+    w.add(start + initDuration(milliseconds = ms), ms)
+  doAssert w.len == 9
+  doAssert w.nextTimeout(start).get <= 1
+
+  var expired: seq[int]
+  for ms in [0, 1, 5, 255, 256, 300, 65_536, 70_000, 20_000_000]:
+    w.advance(start + initDuration(milliseconds = ms + 1), expired)
+    doAssert ms in expired, $expired
+    doAssert expired.allIt(it <= ms + 1), $expired
+  doAssert expired.len == 9
+  doAssert w.len == 0
+  doAssert w.nextTimeout(start).isNone
+
+block: # cancellation
+  var w = initTimerWheel[string]()
+  let start = getMonoTime()
+  let a = w.add(start + initDuration(milliseconds = 10), "a")
+  let b = w.add(start + initDuration(milliseconds = 10), "b")
+  let c = w.add(start + initDuration(seconds = 10), "c")
+  doAssert a.isQueued and b.isQueued and c.isQueued
+  w.cancel(a)
+  w.cancel(c)
+  w.cancel(c)
+  doAssert not a.isQueued
+  doAssert w.len == 1
+  let next = w.nextTimeout(start).get
+  doAssert next in 10..11, $next
+
+  var expired: seq[string]
+  w.advance(start + initDuration(seconds = 20), expired)
+  doAssert expired == @["b"]
+  doAssert not b.isQueued
+  w.cancel(b)
+  doAssert w.len == 0
+
+block: # coarse resolution batches deadlines
+  var w = initTimerWheel[int](initDuration(milliseconds = 50))
+  let start = getMonoTime()
+  for ms in [1, 20, 49]:
+    w.add(start + initDuration(milliseconds = ms), ms)
+  var expired: seq[int]
+  w.advance(start + initDuration(milliseconds = 100), expired)
+  doAssert expired.len == 3
+
+block: # withTimeout
+  proc never(): Future[void] = newFuture[void]("never")
+
+  doAssert waitFor(never().withTimeout(20)) == false
+  doAssert waitFor(sleepAsync(10).withTimeout(10_000))
+  # the timer of the completed `withTimeout` has been cancelled
+  doAssert getGlobalDispatcher().timers.len == 0
+
+block: # sleepAsync with a coarse dispatcher resolution
+  let disp = getGlobalDispatcher()
+  disp.timerResolution = initDuration(milliseconds = 20)
+  doAssert disp.timerResolution == initDuration(milliseconds = 20)
+  let start = getMonoTime()
+  waitFor sleepAsync(30)
+  doAssert getMonoTime() - start >= initDuration(milliseconds = 30)
+  disp.timerResolution = initDuration(milliseconds = 1)
@@ -0,0 +1,88 @@
+#[
+Part of the corpus of `koch benchcompiler`: generic code that is instantiated
+with many types, through several layers of generic procs, iterators,
+containers and concepts.
+]#
+
+import std/[tables, sets, options, sequtils, algorithm, hashes, macros]
+
+type
+  Comparable = concept a, b
+    cmp(a, b) is int
+
+  Vec[N: static int; T] = object
+    data: array[N, T]
+
+  Tree[K, V] = ref object
+    key: K
+    val: V
+    left, right: Tree[K, V]
+
+  Pair[A, B] = tuple[a: A, b: B]
+
+proc `+`[N: static int; T](x, y: Vec[N, T]): Vec[N, T] =
+  result = default(Vec[N, T])
+  for i in 0 ..< N: result.data[i] = x.data[i] + y.data[i]
+
+proc dot[N: static int; T](x, y: Vec[N, T]): T =
+  result = default(T)
+  for i in 0 ..< N: result += x.data[i] * y.data[i]
+
+proc insert[K: Comparable; V](t: var Tree[K, V]; key: K; val: V) =
+  if t == nil: t = Tree[K, V](key: key, val: val)
+  elif cmp(key, t.key) < 0: insert(t.left, key, val)
+  elif cmp(key, t.key) > 0: insert(t.right, key, val)
+  else: t.val = val
+
+iterator items[K, V](t: Tree[K, V]): Pair[K, V] =
+  var stack: seq[Tree[K, V]] = @[]
+  var n = t
+  while n != nil or stack.len > 0:
+    while n != nil:
+      stack.add n
+      n = n.left
+    n = stack.pop
+    yield (n.key, n.val)
+    n = n.right
+
+proc histogram[T](xs: openArray[T]): CountTable[T] =
+  result = initCountTable[T]()
+  for x in xs: result.inc x
+
+proc groupBy[T, K](xs: openArray[T]; key: proc (x: T): K): Table[K, seq[T]] =
+  result = initTable[K, seq[T]]()
+  for x in xs: result.mgetOrPut(key(x), @[]).add x
+
+proc exercise[T](samples: seq[T]) =
+  var t: Tree[T, int] = nil
+  for i, s in samples: t.insert(s, i)
+  var keys: seq[T] = @[]
+  for (k, v) in t: keys.add k
+  doAssert keys == samples.sorted.deduplicate(isSorted = true)
+  let h = histogram(samples)
+  let g = groupBy(samples, proc (x: T): int = hash(x) and 7)
+  let u = samples.toHashSet
+  let o = if samples.len > 0: some(samples.max) else: none(T)
+  let p: Pair[Option[T], seq[T]] = (o, samples.filterIt(it in u))
+  doAssert h.len == u.len and g.len <= 8 and p.b.len == samples.len
+
+macro exerciseAll(types: varargs[typed]): untyped =
+  result = newStmtList()
+  for t in types:
+    for n in [2, 3, 4, 8]:
+      result.add quote do:
+        block:
+          var v: Vec[`n`, `t`]
+          doAssert dot(v + v, v) == default(`t`)
+          exercise(newSeq[`t`](`n`))
+          exercise(@[(default(`t`), `n`)])
+
+exerciseAll(int, int8, int16, int32, int64, uint, uint8, uint16, uint32,
+            uint64, float, float32)
+
+proc main =
+  exercise(@["b", "a", "c"])
+  exercise(@['x', 'y'])
+  exercise(@[(1, "a"), (2, "b")])
+
+main()
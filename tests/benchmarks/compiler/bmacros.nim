@@ -0,0 +1,107 @@
+#[
+Part of the corpus of `koch benchcompiler`: macros that do a lot of work at
+compile time, in the VM, to generate code: serializers for many object types
+and tables computed by compile-time evaluation.
+]#
+
+import std/[macros, strutils, tables]
+
+const N = 300
+
+proc primesBelow(n: int): seq[int] =
+  result = @[]
+  var sieve = newSeq[bool](n)
+  for i in 2 ..< n:
+    if not sieve[i]:
+      result.add i
+      for j in countup(i * i, n - 1, i): sieve[j] = true
+
+const
+  primes = primesBelow(200_000)
+  crcTable = block:
+    var t: array[256, uint32]
+    for i in 0 ..< 256:
+      var c = uint32(i)
+      for _ in 0 ..< 8:
+        c = if (c and 1) != 0: 0xEDB88320'u32 xor (c shr 1) else: c shr 1
+      t[i] = c
+    t
+
+macro genTypes(): untyped =
+  result = newStmtList()
+  for i in 0 ..< N:
+    var fields = newNimNode(nkRecList)
+    for f in 0 ..< 2 + i mod 6:
+      let typ = if f mod 3 == 0: ident"int" elif f mod 3 == 1: ident"string"
+                else: ident"float"
+      fields.add newIdentDefs(ident("f" & $f), typ)
+    result.add nnkTypeSection.newTree(nnkTypeDef.newTree(
+      postfix(ident("Rec" & $i), "*"), newEmptyNode(),
+      nnkObjectTy.newTree(newEmptyNode(), newEmptyNode(), fields)))
+
+genTypes()
+
+macro genSerializer(T: typedesc): untyped =
+  ## Generates `serialize` and `deserialize` for the object type `T`.
+  let impl = getTypeImpl(getTypeImpl(T)[1])
+  let name = T.getTypeInst[1]
+  var ser = newStmtList()
+  var des = newStmtList()
+  let x = ident"x"
+  let res = ident"result"
+  let parts = ident"parts"
+  for i, f in impl[2]:
+    let field = f[0]
+    let key = newLit($field & "=")
+    ser.add quote do:
+      `res`.add `key`
+      `res`.add $`x`.`field`
+      `res`.add ';'
+    var parse = quote do: `parts`[`i`].split('=')[1]
+    case $f[1]
+    of "int": parse = newCall(ident"parseInt", parse)
+    of "float": parse = newCall(ident"parseFloat", parse)
+    else: discard
+    des.add newAssignment(newDotExpr(res, field), parse)
+  result = quote do:
+    proc serialize(`x`: `name`): string =
+      `res` = ""
+      `ser`
+    proc deserialize(s: string; _: typedesc[`name`]): `name` =
+      `res` = default(`name`)
+      let `parts` = s.split(';')
+      `des`
+
+macro genAll(): untyped =
+  result = newStmtList()
+  for i in 0 ..< N:
+    let name = ident("Rec" & $i)
+    result.add quote do:
+      genSerializer(`name`)
+      doAssert deserialize(serialize(default(`name`)), `name`) ==
+        default(`name`)
+
+genAll()
+
+macro dispatch(names: static seq[string]): untyped =
+  ## A `case` over many strings, like command line or protocol handlers.
+  result = newNimNode(nnkCaseStmt).add(ident"cmd")
+  var counts = initTable[char, int]()
+  for name in names:
+    counts.mgetOrPut(name[0], 0).inc
+    result.add nnkOfBranch.newTree(newLit(name), newCall(ident"echo",
+      newLit(name.toUpperAscii & " " & $counts[name[0]])))
+  result.add nnkElse.newTree(newCall(ident"echo", newLit"unknown"))
+
+proc run(cmd: string) =
+  const names = block:
+    var s: seq[string] = @[]
+    for i in 0 ..< 2000: s.add "cmd" & $primes[i]
+    s
+  dispatch(names)
+
+proc main =
+  run("cmd2")
+  echo primes.len, " ", crcTable[255]
+
+main()
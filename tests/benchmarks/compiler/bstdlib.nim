@@ -0,0 +1,94 @@
+#[
+Part of the corpus of `koch benchcompiler`: an ordinary program that imports
+and uses a large part of the standard library, so that most of the time goes
+into checking library code and generating C code for it.
+]#
+
+import std/[json, jsonutils, tables, sets, strutils, strformat, sequtils,
+  algorithm, times, os, parseopt, parsecsv, streams, hashes, math, options,
+  sugar, uri, base64, unicode, critbits, deques, heapqueue,
+  intsets, random, asyncdispatch, asyncnet, httpclient, htmlgen, xmltree,
+  xmlparser, logging, osproc, pegs, re, marshal, typetraits, monotimes]
+
+type
+  Entry = object
+    name: string
+    tags: seq[string]
+    score: float
+    seen: Option[int64]
+
+proc parseEntries(s: string): seq[Entry] =
+  result = @[]
+  var p: CsvParser
+  p.open(newStringStream(s), "entries.csv")
+  defer: p.close()
+  while p.readRow():
+    result.add Entry(name: p.row[0], tags: p.row[1].split(';'),
+                     score: parseFloat(p.row[2]), seen: none(int64))
+
+proc summary(entries: seq[Entry]): JsonNode =
+  var byTag = initTable[string, seq[string]]()
+  var names = initHashSet[string]()
+  var tree: CritBitTree[float]
+  for e in entries:
+    names.incl e.name
+    tree[e.name] = e.score
+    for t in e.tags: byTag.mgetOrPut(t, @[]).add e.name
+  let sorted = entries.sortedByIt(-it.score).mapIt(it.name)
+  result = %*{"count": names.len, "tags": byTag, "best": sorted,
+              "mean": entries.mapIt(it.score).sum / entries.len.float,
+              "sd": entries.mapIt(it.score).foldl(a + b * b, 0.0).sqrt}
+  result["entries"] = entries.toJson
+  result["digest"] = %hash($result)
+
+proc report(j: JsonNode): string =
+  let rows = collect:
+    for k, v in j["tags"]: tr(td(k), td($v.len))
+  result = html(body(h1("Report"), table(rows.join)))
+  result.add fmt"""{j["count"].getInt:>8} entries, mean {j["mean"].getFloat:.2f}"""
+  result.add $encode(result).toRunes.len
+  let x = parseXml("<r>" & xmltree.escape(result) & "</r>")
+  result.add $x.len
+
+proc fetch(url: string): Future[string] {.async.} =
+  let client = newAsyncHttpClient()
+  try:
+    result = await client.getContent(parseUri(url) / "entries.csv")
+  finally:
+    client.close()
+
+proc serve(port: Port) {.async.} =
+  let server = newAsyncSocket()
+  server.bindAddr(port)
+  server.listen()
+  while true:
+    let client = await server.accept()
+    let line = await client.recvLine()
+    await client.send(report(summary(parseEntries(line))) & "\r\n")
+    client.close()
+
+proc main =
+  addHandler newConsoleLogger()
+  var q = initDeque[int]()
+  var h = initHeapQueue[int]()
+  var s = initIntSet()
+  var r = initRand(42)
+  for i in 0 ..< 100:
+    q.addLast r.rand(1000)
+    h.push q.peekLast
+    s.incl q.popFirst
+  info "heap ", h.pop, " set ", s.len, " ", $typeof(h)
+  var input = "a,x;y,1.5\nb,y,2.5\n"
+  for kind, key, val in getopt():
+    if kind == cmdArgument and fileExists(key): input = readFile(key)
+    elif key == "url": input = waitFor fetch(val)
+    elif key == "serve": waitFor serve(Port(parseInt(val)))
+  let t = getMonoTime()
+  let j = summary(parseEntries(input))
+  echo report(j), " ", getMonoTime() - t, " ", now().format("yyyy-MM-dd")
+  echo $$j["count"].getInt, " ", execProcess("echo", args = ["done"],
+    options = {poUsePath})
+  echo input.replacef(re"(\w+),", "$1=").replace(peg"\d+", "#")
+  echo hash(input), " ", input.toRunes.reversed.len
+
+main()
@@ -0,0 +1,45 @@
+discard """
+  action: compile
+"""
+
+#[
+Measures the overhead of `await` on async procs without an `await` of their
+own ("await chain"), which run without a closure iterator and allocate only
+their future, and of futures with several callbacks ("fan out"), which are
+kept inline and in a seq instead of a linked list:
+nim r -d:danger tests/benchmarks/tasyncawait.nim
+Compare with the closure iterator path by adding an `await` of a finished
+future to `leaf`.
+]#
+
+import std/[asyncdispatch, times]
+
+proc leaf(i: int): Future[int] {.async.} =
+  result = i
+
+proc chain(n: int): Future[int] {.async.} =
+  for i in 0 ..< n:
+    result += await leaf(i)
+
+proc fanOut(n, listeners: int) =
+  # every future gets `listeners` callbacks
+  var called = 0
+  for i in 0 ..< n:
+    let fut = newFuture[void]("fanOut")
+    for j in 0 ..< listeners:
+      fut.addCallback(proc () = inc called)
+    fut.complete()
+    drain(0)
+  doAssert called == n * listeners
+
+proc main =
+  let n = 1_000_000
+  var t = cpuTime()
+  doAssert waitFor(chain(n)) == n * (n - 1) div 2
+  echo "await chain: ", cpuTime() - t
+
+  t = cpuTime()
+  fanOut(n div 10, 8)
+  echo "fan out:     ", cpuTime() - t
+
+main()
@@ -0,0 +1,53 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares `FlatTable` with `Table` for insertion, lookups (hits and misses)
+and deletion, for int and string keys of several table sizes:
+nim r -d:danger tests/benchmarks/tflattables.nim
+]#
+
+import std/[tables, flattables, times, strutils]
+
+template bench(name: string, body: untyped) =
+  let t0 = cpuTime()
+  body
+  echo name.alignLeft(36), formatFloat(cpuTime() - t0, ffDecimal, 4)
+
+proc run[K](size: int, key: proc (i: int): K, label: string) =
+  let keys = block:
+    var s = newSeq[K](size)
+    for i in 0 ..< size: s[i] = key(i)
+    s
+  let misses = block:
+    var s = newSeq[K](size)
+    for i in 0 ..< size: s[i] = key(i + size)
+    s
+  let rounds = max(1, 1_000_000 div size)
+  template suite(T, init: untyped) =
+    var t = init
+    var found = 0
+    bench(label & " " & $size & " " & astToStr(T) & " insert"):
+      for r in 0 ..< rounds:
+        t = init
+        for i, k in keys: t[k] = i
+    bench(label & " " & $size & " " & astToStr(T) & " hit"):
+      for r in 0 ..< rounds:
+        for k in keys: found += t.getOrDefault(k)
+    bench(label & " " & $size & " " & astToStr(T) & " miss"):
+      for r in 0 ..< rounds:
+        for k in misses: found += t.getOrDefault(k)
+    bench(label & " " & $size & " " & astToStr(T) & " delete"):
+      for k in keys: t.del(k)
+    doAssert t.len == 0
+    doAssert found > 0
+  suite(Table, initTable[K, int]())
+  suite(FlatTable, initFlatTable[K, int]())
+
+proc main =
+  for size in [1_000, 100_000, 1_000_000]:
+    run(size, proc (i: int): int = i * 7919, "int")
+    run(size, proc (i: int): string = "key-" & $i, "string")
+
+main()
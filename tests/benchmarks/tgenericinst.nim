@@ -0,0 +1,50 @@
+discard """
+  action: compile
+"""
+
+#[
+Compile time benchmark for the caches of generic instantiations: a few
+thousand object types, each used with the same generic types and procs, so
+that every generic has thousands of instantiations to look up:
+time nim c --compileOnly --hints:off tests/benchmarks/tgenericinst.nim
+]#
+
+import std/[macros, tables, sets, options]
+import std/assertions
+
+const N = 2000
+
+macro genTypes(): untyped =
+  result = newStmtList()
+  for i in 0 ..< N:
+    let name = ident("T" & $i)
+    result.add quote do:
+      type `name` = object
+        x: int
+
+genTypes()
+
+type Box[T] = object
+  val: T
+
+proc boxed[T](x: T): Box[T] = Box[T](val: x)
+proc unbox[T](b: Box[T]): T = b.val
+
+macro useAll(): untyped =
+  result = newStmtList()
+  for i in 0 ..< N:
+    let name = ident("T" & $i)
+    result.add quote do:
+      block:
+        var t = initTable[int, `name`]()
+        t[1] = `name`(x: 1)
+        var s = initHashSet[int]()
+        s.incl 1
+        doAssert unbox(boxed(t[1])).x == 1
+        doAssert some(`name`(x: 2)).get.x == 2
+        doAssert 1 in s
+
+proc main =
+  useAll()
+
+main()
@@ -0,0 +1,37 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares the throughput of `hash` and `hashWy` for strings of several lengths:
+nim r -d:danger tests/benchmarks/thashes.nim
+nim r -d:danger -d:nimStringHashWy tests/benchmarks/thashes.nim
+]#
+
+import std/[hashes, times, strutils]
+
+proc bench(len: int) =
+  var s = newString(len)
+  for i in 0 ..< len: s[i] = char(32 + (i * 37) mod 95)
+  let rounds = max(1, 200_000_000 div max(len, 8))
+  var sink = 0
+
+  var t = cpuTime()
+  for i in 0 ..< rounds:
+    s[0] = char(i and 127) # keeps the loop from being hoisted
+    sink = sink xor hash(s)
+  let farm = cpuTime() - t
+
+  t = cpuTime()
+  for i in 0 ..< rounds:
+    s[0] = char(i and 127)
+    sink = sink xor hashWy(s)
+  let wy = cpuTime() - t
+
+  template rate(sec: float): string =
+    formatFloat(float(len) * float(rounds) / sec / 1e9, ffDecimal, 2) & " GB/s"
+  echo align($len, 6), "  hash: ", rate(farm).align(12), "  hashWy: ",
+       rate(wy).align(12), "  ", sink and 1
+
+for len in [4, 8, 16, 32, 64, 128, 1024, 65536]:
+  bench(len)
@@ -0,0 +1,30 @@
+discard """
+  action: compile
+"""
+
+#[
+Measures the throughput of the JSON lexer on NDJSON input:
+nim r -d:danger tests/benchmarks/tjsonparse.nim
+]#
+
+import std/[json, streams, strutils, times]
+
+proc makeInput(records: int): string =
+  for i in 0 ..< records:
+    result.add """{"id": $1, "name": "user-$1", "email": "user$1@example.com", "bio": "$2", "score": $3, "tags": ["alpha", "beta", "gamma"], "active": true}""" % [
+      $i, "lorem ipsum dolor sit amet ".repeat(4), $(i.float * 0.25)]
+    result.add '\n'
+
+proc main =
+  let input = makeInput(200_000)
+  let t = cpuTime()
+  var n = 0
+  for x in parseJsonFragments(newStringStream(input)):
+    n += x["tags"].len
+  let elapsed = cpuTime() - t
+  doAssert n == 600_000
+  echo "parsed ", formatFloat(input.len / 1e6, ffDecimal, 1), " MB in ",
+    formatFloat(elapsed, ffDecimal, 3), " s (",
+    formatFloat(input.len / 1e6 / elapsed, ffDecimal, 1), " MB/s)"
+
+main()
@@ -0,0 +1,47 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares serializing a large value with `JsonWriter` against building a
+`JsonNode` first:
+nim r -d:danger tests/benchmarks/tjsonwriter.nim
+]#
+
+import std/[json, jsonutils, streams, times]
+
+type
+  Item = object
+    id: int
+    name: string
+    price: float
+    tags: seq[string]
+    available: bool
+
+proc main =
+  var items: seq[Item]
+  for i in 0 ..< 200_000:
+    items.add Item(id: i, name: "item " & $i, price: i.float * 0.5,
+                   tags: @["a", "b"], available: i mod 2 == 0)
+
+  var t = cpuTime()
+  let viaNode = $ %*items
+  echo "$ %*items:   ", cpuTime() - t
+
+  t = cpuTime()
+  let viaToJson = $toJson(items)
+  echo "$toJson:     ", cpuTime() - t
+
+  t = cpuTime()
+  var size = 0
+  var w = initJsonWriter(proc (chunk: string) = size += chunk.len)
+  w.writeJson(items)
+  w.flush()
+  echo "JsonWriter:  ", cpuTime() - t
+
+  let s = newStringStream()
+  s.writeJson(items)
+  doAssert s.data == viaToJson
+  doAssert size == viaNode.len
+
+main()
@@ -0,0 +1,54 @@
+discard """
+  action: compile
+"""
+
+#[
+Measures the throughput of the compiler's lexer alone, by default on all
+modules of the standard library, or on the files given on the command line:
+nim r -d:danger tests/benchmarks/tlexer.nim [file.nim ...]
+]#
+
+import ../../compiler/[lexer, llstream, idents, options, pathutils]
+import std/[os, times, strutils]
+
+when defined(nimPreviewSlimSystem):
+  import std/syncio
+
+proc lexAll(files: seq[string]; contents: seq[string]): int =
+  ## Returns the number of tokens.
+  result = 0
+  let cache = newIdentCache()
+  let config = newConfigRef()
+  for i, f in files:
+    var L: Lexer
+    var tok: Token
+    openLexer(L, AbsoluteFile f, llStreamOpen(contents[i]), cache, config)
+    while true:
+      rawGetTok(L, tok)
+      inc result
+      if tok.tokType == tkEof: break
+    closeLexer(L)
+
+proc main =
+  var files: seq[string] = @[]
+  for i in 1..paramCount(): files.add paramStr(i)
+  if files.len == 0:
+    for f in walkDirRec(currentSourcePath.parentDir / "../../lib"):
+      if f.endsWith(".nim"): files.add f
+  var contents: seq[string] = @[]
+  var size = 0
+  for f in files:
+    contents.add readFile(f)
+    inc size, contents[^1].len
+
+  var best = Inf
+  var tokens = 0
+  for run in 0..<5:
+    let t = epochTime()
+    tokens = lexAll(files, contents)
+    best = min(best, epochTime() - t)
+  echo "lexed ", files.len, " files, ", formatSize(size), ", ", tokens, " tokens"
+  echo "best of 5: ", formatFloat(best * 1000, ffDecimal, 1), " ms, ",
+    formatFloat(size / best / 1e6, ffDecimal, 1), " MB/s"
+
+main()
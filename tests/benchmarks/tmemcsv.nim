@@ -0,0 +1,54 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares parsecsv with memcsv, on one thread and on all processors:
+nim r -d:danger --threads:on tests/benchmarks/tmemcsv.nim
+]#
+
+import std/[memcsv, parsecsv, os, times, cpuinfo, typedthreads]
+
+proc sumChunk(c: CsvChunk): float =
+  var r = initCsvReader(c)
+  while r.readRow():
+    result += r.get(2, float)
+
+proc worker(job: tuple[c: CsvChunk, res: ptr float]) {.thread.} =
+  job.res[] = sumChunk(job.c)
+
+proc main =
+  let path = getTempDir() / "tmemcsv_bench.csv"
+  var f = open(path, fmWrite)
+  for i in 0 ..< 2_000_000:
+    f.write $i, ",\"user ", $(i mod 1000), "\",", $(i.float * 0.25), "\n"
+  f.close()
+
+  var t = cpuTime()
+  var p: CsvParser
+  p.open(path)
+  var sum = 0.0
+  while p.readRow():
+    sum += parseFloat(p.row[2])
+  p.close()
+  echo "parsecsv:          ", cpuTime() - t, " s, sum ", sum
+
+  var csv = openCsvMap(path)
+  t = epochTime()
+  sum = sumChunk(csv.chunk)
+  echo "memcsv:            ", epochTime() - t, " s, sum ", sum
+
+  t = epochTime()
+  let chunks = csv.chunks(countProcessors())
+  var sums = newSeq[float](chunks.len)
+  var threads = newSeq[Thread[tuple[c: CsvChunk, res: ptr float]]](chunks.len)
+  for i in 0 ..< chunks.len:
+    createThread(threads[i], worker, (chunks[i], addr sums[i]))
+  joinThreads(threads)
+  sum = 0.0
+  for s in sums: sum += s
+  echo "memcsv, ", chunks.len, " threads: ", epochTime() - t, " s, sum ", sum
+  csv.close()
+  removeFile(path)
+
+main()
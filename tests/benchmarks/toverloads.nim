@@ -0,0 +1,38 @@
+discard """
+  action: compile
+"""
+
+#[
+Compile time benchmark for overload resolution: long procs that call the same
+heavily overloaded routines with the same argument types over and over, which
+the compiler resolves once per scope and then only checks again:
+time nim c --compileOnly --hints:off tests/benchmarks/toverloads.nim
+]#
+
+import std/[macros, strutils]
+import std/assertions
+
+const N = 5000
+
+macro repeatCalls(): untyped =
+  result = newStmtList()
+  for i in 0 ..< N:
+    result.add quote do:
+      x = x + y
+      y = y xor x
+      s.add $x
+      s.add sep
+      found = found or s.contains(sep)
+      f = f * g + toFloat(x and 1023)
+      inc y
+
+proc main =
+  var x, y = 1
+  var s = ""
+  let sep = ","
+  var found = false
+  var f, g = 1.0
+  repeatCalls()
+  doAssert found and s.len > 0 and f > 0
+
+main()
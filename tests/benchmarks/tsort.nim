@@ -0,0 +1,35 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares the sort procs on 10M integers and 1M strings:
+nim r -d:danger tests/benchmarks/tsort.nim
+]#
+
+import std/[algorithm, parallelsort, random, strutils, times]
+
+template bench(name: string, data: typed, body: untyped) =
+  block:
+    var a {.inject.} = data
+    let t = epochTime()
+    body
+    let elapsed = epochTime() - t
+    doAssert a.isSorted
+    echo alignLeft(name, 28), formatFloat(elapsed, ffDecimal, 3), " s"
+
+proc main =
+  var r = initRand(42)
+  var ints = newSeq[int](10_000_000)
+  for x in ints.mitems: x = r.rand(int.high)
+  var strs = newSeq[string](1_000_000)
+  for x in strs.mitems: x = $r.rand(int.high)
+
+  bench("sort(cmp) ints", ints): a.sort(system.cmp[int])
+  bench("sort ints", ints): a.sort()
+  bench("radixSort ints", ints): a.radixSort()
+  bench("parallelSort ints", ints): a.parallelSort()
+  bench("sort strings", strs): a.sort()
+  bench("parallelSort strings", strs): a.parallelSort()
+
+main()
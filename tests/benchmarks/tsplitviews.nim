@@ -0,0 +1,35 @@
+discard """
+  action: compile
+"""
+
+#[
+Compares splitting TSV lines into strings and into views:
+nim r -d:danger tests/benchmarks/tsplitviews.nim
+]#
+
+import std/[strutils, strviews, times]
+
+proc main =
+  var input = ""
+  for i in 0 ..< 1_000_000:
+    input.add "$1\tuser-$1\t$2\t$3\n" % [$i, $(i mod 100), $(i.float * 0.5)]
+
+  var t = cpuTime()
+  var sum = 0.0
+  for line in input.splitLines:
+    let fields = line.split('\t')
+    if fields.len == 4: sum += parseInt(fields[2]).float + parseFloat(fields[3])
+  echo "strings: ", formatFloat(cpuTime() - t, ffDecimal, 3), " s"
+
+  t = cpuTime()
+  var sum2 = 0.0
+  for line in input.splitLinesView:
+    var i = 0
+    for field in line.toOpenArray.splitView('\t'):
+      if i == 2: sum2 += parseInt(field).float
+      elif i == 3: sum2 += parseFloat(field)
+      inc i
+  echo "views:   ", formatFloat(cpuTime() - t, ffDecimal, 3), " s"
+  doAssert sum == sum2
+
+main()
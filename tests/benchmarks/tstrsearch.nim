@@ -0,0 +1,50 @@
+discard """
+  action: compile
+"""
+
+#[
+Measures the string search procs of strutils on log-like input:
+nim r -d:danger tests/benchmarks/tstrsearch.nim
+]#
+
+import std/[strutils, times]
+
+proc makeLog(lines: int): string =
+  for i in 0 ..< lines:
+    result.add "2026-01-01T00:00:00 host-$1 service[$2]: request handled in $3 ms\tstatus=200\n" % [
+      $(i mod 17), $(i mod 1000), $(i mod 97)]
+    if i mod 5000 == 0:
+      result.add "2026-01-01T00:00:00 host-1 service[1]: fatal error, disk full\n"
+
+template bench(name: string, body: untyped) =
+  block:
+    let t = cpuTime()
+    body
+    let elapsed = cpuTime() - t
+    echo alignLeft(name, 24), formatFloat(log.len / 1e6 / elapsed, ffDecimal, 1), " MB/s"
+
+proc main =
+  let log = makeLog(500_000)
+  var n = 0
+  bench("find(set)"):
+    var i = 0
+    while (i = log.find({'\t', '|'}, i); i >= 0):
+      inc n
+      inc i
+  bench("find(string)"):
+    var i = 0
+    while (i = log.find("fatal", i); i >= 0):
+      inc n
+      inc i
+  bench("split(char)"):
+    for field in log.split('\t'):
+      n += field.len
+  bench("multiReplace"):
+    n += log.multiReplace(("fatal", "FATAL"), ("\t", " ")).len
+  let m = initMultiSearcher(["fatal", "panic", "segfault", "oom-killer", "denied"])
+  bench("MultiSearcher"):
+    for x in m.findAll(log):
+      inc n
+  echo n
+
+main()
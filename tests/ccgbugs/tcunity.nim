@@ -0,0 +1,29 @@
+discard """
+  matrix: "--cUnity:1; --cUnity:3; --cUnity:3 --threads:on --mm:refc"
+  output: '''
+a-b-c
+@[3, 4]
+6
+ab c
+'''
+"""
+
+# the generated C files are merged into a few translation units, so types and
+# inline procs used by several modules must not clash; `set[char]` is also
+# used by strutils
+import std/[strutils, tables, sequtils, sets]
+
+var threadLocal {.threadvar.}: int
+
+proc main =
+  var t = initTable[string, seq[int]]()
+  t["x"] = @[1, 2, 3, 4]
+  echo ["a", "b", "c"].join("-")
+  echo t["x"].filterIt(it > 2)
+  var s = toHashSet([1, 2, 3])
+  threadLocal = s.len
+  for x in s: inc threadLocal, x - 1
+  echo threadLocal
+  let trim: set[char] = Whitespace + {'x'}
+  echo " xab cx ".strip(chars = trim)
+main()
@@ -0,0 +1,28 @@
+discard """
+  output: '''
+circle 3
+square 4
+'''
+  ccodecheck: "\\i !@('never constructed')"
+"""
+
+# methods are only generated with the RTTI of a type that can dispatch to them
+
+type
+  Shape = ref object of RootObj
+  Circle = ref object of Shape
+    r: int
+  Square = ref object of Shape
+    a: int
+  Triangle = ref object of Shape
+
+method name(s: Shape): string {.base.} = "shape"
+method name(s: Circle): string = "circle " & $s.r
+method name(s: Square): string = "square " & $s.a
+method name(s: Triangle): string = "never constructed"
+
+proc main =
+  let shapes = @[Shape(Circle(r: 3)), Square(a: 4)]
+  for s in shapes:
+    echo s.name
+main()
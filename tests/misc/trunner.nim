@@ -407,6 +407,50 @@ running: v2
     doAssert outp2 == "12345\n", outp2
     doAssert status2 == 0
 
+  block: # --pgo
+    const nimcache2 = buildDir / "D20261019T101500"
+    removeDir(nimcache2)
+    let input = "tpgo_fakefile"
+    let (output, status) = runNimCmd(input, fmt"""--pgo:bogus --eval:"echo(1)" """)
+    doAssert status != 0
+    doAssert "'gen', 'use' or 'off' expected, but 'bogus' found" in output, output
+    proc header(options: string): string =
+      # the C compiler command in the header leaves out the `--pgo` options,
+      # so that the instrumented and the optimized build see the same C code
+      discard runNimCmdChk(input, fmt"""--nimcache:{nimcache2.quoteShell} {options} --eval:"echo(1)" """)
+      let ext = if mode == "cpp": "cpp" else: "c"
+      for file in walkFiles(nimcache2 / "*system.nim." & ext):
+        var command = false
+        for line in lines(file):
+          if command: return line
+          command = line.startsWith("/* Command for C compiler:")
+      doAssert false, "no C file with a header in " & nimcache2
+    let pgoDir = nimcache2 / "pgo"
+    doAssert header("") == header(fmt"--pgo:gen:{pgoDir.quoteShell}")
+    doAssert dirExists(pgoDir)
+
+  block: # --profileCompiler
+    const nimcache2 = buildDir / "D20261019T103000"
+    removeDir(nimcache2)
+    let trace = nimcache2 / "trace.json"
+    discard runNimCmdChk("tprofile_fakefile", fmt"""--compileOnly --nimcache:{nimcache2.quoteShell} --profileCompiler:{trace.quoteShell} --eval:"import std/strutils; echo(repeat('a', 3))" """)
+    let j = parseFile(trace)
+    var modules: seq[string] = @[]
+    var counters = 0
+    for e in j["traceEvents"]:
+      if e{"cat"}.getStr == "module":
+        doAssert e["ph"].getStr == "X"
+        doAssert e["dur"].getFloat >= 0
+        modules.add e["name"].getStr
+      elif e["ph"].getStr == "C":
+        doAssert e["name"].getStr == "counters"
+        doAssert e["args"]["generic instantiations"].getInt >= 0
+        inc counters
+    doAssert "system" in modules.mapIt(it.splitFile.name), $modules
+    doAssert "strutils" in modules.mapIt(it.splitFile.name), $modules
+    doAssert counters >= modules.len, $counters
+    doAssert j["otherData"]["peak memory"].getInt > 0
+
   block: # UnusedImport
     proc fn(opt: string, expected: string) =
       let output = runNimCmdChk("msgs/mused3.nim", fmt"--warning:all:off --warning:UnusedImport --hint:DuplicateModuleImport {opt}")
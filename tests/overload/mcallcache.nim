@@ -0,0 +1,2 @@
+proc g*(x: int): string = "imported g"
+proc h*(x: int): string = "imported h"
@@ -0,0 +1,40 @@
+# the same call is resolved again after something that can change its
+# resolution, instead of reusing the remembered overload
+
+block: # a better overload in the same scope
+  proc f(x: float): string = "float"
+  let i = 1
+  doAssert f(i) == "float"
+  proc f(x: int): string = "int"
+  doAssert f(i) == "int"
+
+block: # a converter
+  type Meters = distinct int
+  proc k(a, b: float, c: Meters): string = "float"
+  proc k(a, b: int, c: string): string = "string"
+  let i = 1
+  let m = Meters(2)
+  doAssert k(i, i, m) == "float"
+  converter toString(x: Meters): string = $int(x)
+  doAssert k(i, i, m) == "string"
+
+block: # a redefined template, which replaces the old one in the scope
+  proc t(x: float): string = "proc"
+  template t(x: int): string = "first"
+  let i = 1
+  doAssert t(i) == "first"
+  template t(x: int): string {.redefine.} = "second"
+  doAssert t(i) == "second"
+
+# imports
+let j = 1
+
+proc h(x: float): string = "local h"
+doAssert h(j) == "local h"
+from mcallcache import h
+doAssert h(j) == "imported h"
+
+proc g(x: float): string = "local g"
+doAssert g(j) == "local g"
+import mcallcache
+doAssert g(j) == "imported g"
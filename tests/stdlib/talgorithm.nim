@@ -273,3 +273,49 @@ proc main() =
 
 static: main()
 main()
+
+when not defined(js):
+  template testRadixSort() =
+    block:
+      var a = [3'i8, -1, 127, -128, 0, 5, -1]
+      a.radixSort()
+      doAssert a == [-128'i8, -1, -1, 0, 3, 5, 127]
+      a.radixSort(Descending)
+      doAssert a == [127'i8, 5, 3, 0, -1, -1, -128]
+
+    block:
+      var a = @[1e10, -0.5, Inf, 2.5, -Inf, 0.0, -3.0, 1e-300]
+      a.radixSort()
+      doAssert a == @[-Inf, -3.0, -0.5, 0.0, 1e-300, 2.5, 1e10, Inf]
+      var b = @[2.5'f32, -1.5, 0.25, -100]
+      b.radixSort()
+      doAssert b == @[-100'f32, -1.5, 0.25, 2.5]
+
+    block:
+      var a = newSeq[int](1000)
+      var b = newSeq[uint32](1000)
+      for i in 0 ..< a.len:
+        a[i] = (i * 7919 mod 1009 - 500) * 1_000_003
+        b[i] = uint32(i * 2654435761 mod 4294967296)
+      var c = a
+      c.sort()
+      a.radixSort()
+      doAssert a == c
+      b.radixSort()
+      doAssert b.isSorted
+      a.radixSort(Descending)
+      doAssert a == c.reversed
+      var s = "radix sort"
+      s.radixSort()
+      doAssert s == " adiorrstx"
+
+    block: # sorting by a key is stable
+      type Person = tuple[name: string, age: int]
+      var people: seq[Person] = @[("a", 30), ("b", -20), ("c", 30), ("d", 40000), ("e", -20)]
+      people.radixSort(proc (p: Person): int = p.age)
+      doAssert people == @[("b", -20), ("e", -20), ("a", 30), ("c", 30), ("d", 40000)]
+      people.radixSort(proc (p: Person): int16 = int16(p.age div 10), Descending)
+      doAssert people.mapIt(it.name) == @["d", "a", "c", "b", "e"]
+
+  static: testRadixSort()
+  testRadixSort()
@@ -0,0 +1,102 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp js"
+"""
+
+import std/[flattables, tables, random, hashes, strutils]
+import std/assertions
+
+template fn() =
+  block: # basic operations
+    var t: FlatTable[string, int]
+    doAssert t.len == 0
+    doAssert "a" notin t
+    doAssert t.getOrDefault("a") == 0
+    t["a"] = 1
+    t["b"] = 2
+    t["a"] = 3
+    doAssert t.len == 2
+    doAssert t["a"] == 3
+    t["b"] += 10
+    doAssert t["b"] == 12
+    doAssert t.mgetOrPut("c", 5) == 5
+    doAssert not t.hasKeyOrPut("d", 7)
+    doAssert t.hasKeyOrPut("d", 8)
+    doAssert t["d"] == 7
+    var v: int
+    doAssert t.pop("c", v) and v == 5
+    doAssert not t.pop("c", v)
+    t.del("zz")
+    doAssert t.len == 3
+    doAssertRaises(KeyError): discard t["zz"]
+    doAssert t == {"d": 7, "b": 12, "a": 3}.toFlatTable
+    doAssert $initFlatTable[int, int]() == "{:}"
+    doAssert ${"x": 1}.toFlatTable == """{"x": 1}"""
+    t.clear()
+    doAssert t.len == 0 and "a" notin t
+
+  block: # many keys, growth and deletions agree with Table
+    var r = initRand(42)
+    var t = initFlatTable[int, int](4)
+    var expected: Table[int, int]
+    for i in 0 ..< 3000:
+      let k = r.rand(700)
+      case r.rand(3)
+      of 0, 1:
+        t[k] = i
+        expected[k] = i
+      of 2:
+        t.del(k)
+        expected.del(k)
+      else:
+        doAssert t.getOrDefault(k, -1) == expected.getOrDefault(k, -1)
+    doAssert t.len == expected.len
+    for k, v in t.pairs:
+      doAssert expected[k] == v
+    var n = 0
+    for v in t.mvalues:
+      v = -v
+      inc n
+    doAssert n == t.len
+    for k, v in expected:
+      doAssert t[k] == -v
+
+type Collide = distinct int
+proc hash(x: Collide): Hash = Hash(int(x) mod 3)
+proc `==`(a, b: Collide): bool {.borrow.}
+
+template collisions() =
+  block: # long probe sequences that wrap around the end of the table
+    var t = initFlatTable[Collide, string](8)
+    for i in 0 ..< 60:
+      t[Collide(i)] = $i
+    for i in countup(0, 59, 2):
+      t.del(Collide(i))
+    doAssert t.len == 30
+    for i in 0 ..< 60:
+      doAssert (Collide(i) in t) == (i mod 2 == 1)
+      if i mod 2 == 1: doAssert t[Collide(i)] == $i
+
+var hashCalls = 0
+type Counted = distinct int
+proc hash(x: Counted): Hash =
+  inc hashCalls
+  hash(int(x))
+proc `==`(a, b: Counted): bool {.borrow.}
+
+template storedHashes() =
+  block: # growing and deleting reuse the stored hashes
+    var t: FlatTable[Counted, int]
+    for i in 0 ..< 1000:
+      t[Counted(i)] = i
+    doAssert hashCalls == 1000
+    for i in 0 ..< 500:
+      t.del(Counted(i))
+    doAssert hashCalls == 1500
+    for i in 500 ..< 1000:
+      doAssert t[Counted(i)] == i
+
+static: fn()
+fn()
+collisions()
+storedHashes()
@@ -88,6 +88,12 @@ block smallSize: # no multibyte hashing
   doAssert hash(xx) == hash(xx, 0, xx.high)
   doAssert hash(ss) == hash(ss, 0, ss.high)
 
+block hashData:
+  when not defined(js):
+    let s = "some bytes that are longer than a word"
+    doAssert hashData(s[0].addr, s.len) == hash(s)
+    doAssert hashData(nil, 0) == hash("")
+
 block largeSize: # longer than 4 characters
   let
     xx = @['H', 'e', 'l', 'l', 'o']
@@ -103,6 +109,32 @@ block largeSize: # longer than 4 characters
 
 proc main() =
   doAssert hash(0.0) == hash(0)
+
+  when not sHash2:
+    block: # hashWy
+      when not defined(js):
+        # the test vectors of the reference implementation, with seed = index
+        let vectors = [("", 0x93228a4de0eec5a2'u64), ("a", 0xc5bac3db178713c4'u64),
+          ("abc", 0xa97f2f7b1d9b3314'u64), ("message digest", 0x786d1f1df3801df4'u64),
+          ("abcdefghijklmnopqrstuvwxyz", 0xdca5a8138ad37c87'u64),
+          ("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789",
+           0xb9e734f117cfaf70'u64),
+          ("12345678901234567890123456789012345678901234567890123456789012345678901234567890",
+           0x6cc5eab49a92d617'u64)]
+        for i, (s, h) in vectors:
+          doAssert hashWy(s, uint64(i)) == cast[Hash](h)
+        doAssert hashWy("abracadabra") == cast[Hash](0x82091bcff844e783'u64)
+      var bytes: seq[byte]
+      var chars = ""
+      var seen: seq[Hash]
+      for n in 0 .. 100:
+        let h = hashWy(bytes)
+        doAssert h == hashWy(chars)
+        doAssert h notin seen
+        doAssert h != hashWy(bytes, seed = 1)
+        seen.add h
+        bytes.add byte(n * 7)
+        chars.add char(n * 7)
   # bug #16061
   when not sHash2: # Hash=int=4B on js even w/--jsbigint64:on => cast[Hash]
     doAssert hash(cstring"abracadabra") == cast[Hash](-1119910118870047694i64)
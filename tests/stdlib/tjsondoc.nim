@@ -0,0 +1,73 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[jsondoc, json, streams]
+import std/assertions
+
+const input = """
+{
+  "id": 42, "big": 123456789012345678901234567890,
+  "pi": 3.25, "ok": true, "no": false, "nothing": null,
+  "name": "café \"x\"",
+  "nested": {"a": [1, [2, 3], {"b": "c"}], "empty": {}, "none": []},
+  "dup": 1, "dup": 2
+}"""
+
+block: # accessors
+  let doc = parseJsonDoc(input)
+  let r = doc.root
+  doAssert r.kind == JObject
+  doAssert r.len == 10
+  doAssert r["id"].getInt == 42
+  doAssert r["id"].getFloat == 42.0
+  doAssert r["pi"].getFloat == 3.25
+  doAssert r["ok"].getBool and not r["no"].getBool
+  doAssert r["nothing"].kind == JNull
+  doAssert r["name"].getStr == "café \"x\""
+  doAssert r["big"].kind == JString
+  doAssert r["dup"].getInt == 2
+  # unlike `JsonNode`, every pair of a duplicate key is kept
+  doAssert parseJson(input).len == 9
+  var dups: seq[int]
+  for k, v in r.pairs:
+    if k == "dup": dups.add v.getInt
+  doAssert dups == @[1, 2]
+  doAssert r.toJsonNode["dup"].getInt == 2
+  doAssert r["name"].getInt(-1) == -1
+
+  let a = r["nested"]["a"]
+  doAssert a.len == 3
+  doAssert a[0].getInt == 1
+  doAssert a[1][1].getInt == 3
+  doAssert a[2]["b"].getStr == "c"
+  doAssert r{"nested", "a"}.len == 3
+  doAssert r{"nested", "missing"}.isNil
+  doAssert r{"id", "x"}.isNil
+  doAssert r{"nested", "missing"}.getStr("d") == "d"
+  doAssert r["nested"]["empty"].len == 0
+  doAssert "id" in r and not r.hasKey("di")
+  doAssertRaises(KeyError): discard r["di"]
+  doAssertRaises(IndexDefect): discard a[3]
+
+  var sum = 0
+  for x in a[1]: sum += x.getInt
+  doAssert sum == 5
+  var keys: seq[string]
+  for k in r["nested"].keys: keys.add k
+  doAssert keys == @["a", "empty", "none"]
+
+block: # serialization and JsonNode view match json
+  let doc = parseJsonDoc(newStringStream(input))
+  let node = parseJson(input)
+  doAssert doc.root.toJsonNode == node
+  doAssert $doc.root["nested"] == $node["nested"]
+  doAssert $doc.root["big"] == "123456789012345678901234567890"
+  doAssert $parseJsonDoc("[1.5, -0.0, 1e300]").root == $parseJson("[1.5, -0.0, 1e300]")
+  doAssert parseJsonDoc("\"s\"").root.getStr == "s"
+
+block: # errors
+  doAssertRaises(JsonParsingError): discard parseJsonDoc("[1, 2")
+  doAssertRaises(JsonParsingError): discard parseJsonDoc("{\"a\" 1}")
+  doAssertRaises(JsonParsingError): discard parseJsonDoc("1 2")
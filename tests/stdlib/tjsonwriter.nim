@@ -0,0 +1,81 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[jsonutils, json, options, tables, sets, strtabs, streams, strutils]
+import std/assertions
+
+type
+  Color = enum red, green, blue
+  HoleyEnum = enum h1 = 1, h5 = 5
+  Meters = distinct float
+  Inner = object
+    name: string
+    tags: seq[string]
+  Outer = ref object
+    id: int
+    small: int8
+    big: uint64
+    ratio: float32
+    color: Color
+    holey: HoleyEnum
+    ch: char
+    flag: bool
+    inner: Inner
+    next: Outer
+    maybe, nothing: Option[int]
+    table: OrderedTable[string, int]
+    hs: HashSet[int]
+    arr: array[2, uint8]
+    bits: set[Color]
+    tup: (int, string)
+    named: tuple[a: int, b: cstring]
+    node: JsonNode
+    st: StringTableRef
+    dist: Meters
+    floats: seq[float]
+
+proc sample(): Outer =
+  result = Outer(id: -7, small: -3, big: high(uint64), ratio: 1.5, color: blue,
+                 holey: h5, ch: 'x', flag: true,
+                 inner: Inner(name: "quote\" and \\ and \n", tags: @["a", "b"]),
+                 maybe: some(3), table: {"k": 1, "j": 2}.toOrderedTable,
+                 hs: [4].toHashSet,
+                 arr: [1'u8, 255], bits: {red, blue}, tup: (2, "t"),
+                 named: (a: 1, b: nil), node: %*{"free": [1, "form", nil]},
+                 st: newStringTable("a", "b", modeCaseSensitive),
+                 dist: Meters(2.5), floats: @[NaN, Inf, -Inf, 0.0, -0.0, 1e-2])
+  result.next = Outer(node: newJNull())
+
+proc check[T](x: T, opt = initToJsonOptions()) =
+  let expected = $toJson(x, opt)
+  let s = newStringStream()
+  s.writeJson(x, opt)
+  doAssert s.data == expected, "\n" & s.data & "\n" & expected
+  # tiny chunks: the output is split but complete
+  var chunks: seq[string]
+  var w = initJsonWriter(proc (chunk: string) = chunks.add chunk, opt, chunkSize = 16)
+  w.writeJson(x)
+  w.flush()
+  doAssert chunks.join == expected
+  if expected.len > 64:
+    doAssert chunks.len > 1
+
+block:
+  check(sample())
+  check(@[sample(), nil])
+  check(sample(), ToJsonOptions(enumMode: joptEnumString, jsonNodeMode: joptJsonNodeAsCopy))
+  check(sample(), ToJsonOptions(enumMode: joptEnumSymbol))
+  check("")
+  check(none(string))
+  check(newSeq[int]())
+
+block: # several values through one writer
+  let s = newStringStream()
+  var w = initJsonWriter(s)
+  for i in 0 ..< 3:
+    w.writeJson(i)
+    w.writeJson("\n")
+  w.flush()
+  doAssert s.data == "0\"\\n\"1\"\\n\"2\"\\n\""
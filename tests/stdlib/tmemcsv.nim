@@ -0,0 +1,103 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[memcsv, os]
+import std/assertions
+
+type Color = enum red, green
+
+proc rows(c: CsvChunk): seq[seq[string]] =
+  var r = initCsvReader(c)
+  while r.readRow():
+    var row: seq[string]
+    for i in 0 ..< r.len: row.add r.getStr(i)
+    result.add row
+
+block: # fields, quotes and line ends
+  let data = "a,b,c\r\n\n1,\"x,\"\"y\"\"\",\r\n\"multi\nline\",,3\n4,5,6"
+  var r = initCsvReader(toCsvChunk(data))
+  doAssert r.readRow(3)
+  doAssert r[0] == "a" and r[2] == "c"
+  doAssert r.readRow(3)
+  doAssert r[1] == "x,\"\"y\"\"" and r.getStr(1) == "x,\"y\""
+  doAssert r[2].len == 0
+  doAssert r.readRow(3)
+  doAssert r.getStr(0) == "multi\nline"
+  doAssert r[1] == ""
+  doAssert r.readRow(3)
+  doAssert r.get(2, int) == 6
+  doAssert not r.readRow()
+  doAssert rows(toCsvChunk("x,")) == @[@["x", ""]]
+  doAssert rows(toCsvChunk("")).len == 0
+
+block: # typed fields
+  var r = initCsvReader(toCsvChunk("-12, 2.5 ,Yes,green,300,x\n"))
+  doAssert r.readRow()
+  doAssert r.get(0, int) == -12
+  doAssert r.get(0, int8) == -12
+  doAssert r.get(1, float) == 2.5
+  doAssert r.get(2, bool)
+  doAssert r.get(3, Color) == green
+  doAssert r.get(4, uint16) == 300
+  doAssert r.get(5, string) == "x"
+  doAssertRaises(ValueError): discard r.get(4, int8)
+  doAssertRaises(ValueError): discard r.get(0, uint)
+  doAssertRaises(ValueError): discard r.get(5, int)
+  doAssertRaises(ValueError): discard r.get(5, bool)
+  doAssert r.getRow(tuple[a: int, b: float]) == (a: -12, b: 2.5)
+
+block: # errors
+  var r = initCsvReader(toCsvChunk("a,b\n\"open,c\n"))
+  doAssert r.readRow()
+  doAssertRaises(CsvError): discard r.readRow()
+  r = initCsvReader(toCsvChunk("a,\"b\"c\n"))
+  doAssertRaises(CsvError): discard r.readRow()
+  r = initCsvReader(toCsvChunk("a,b\nc\n"))
+  doAssert r.readRow(2)
+  try:
+    discard r.readRow(2)
+    doAssert false
+  except CsvError as e:
+    doAssert e.msg == "(2, 1) Error: 2 columns expected, but found 1 columns"
+
+block: # memory mapped files and chunks
+  let path = getTempDir() / "tmemcsv.csv"
+  var data = "id;name;note\n"
+  for i in 0 ..< 500:
+    data.add $i & ";name " & $i & ";"
+    if i mod 7 == 0: data.add "\"a; \"\"quoted\"\"\nnote\r\nover lines\""
+    data.add "\n"
+  writeFile(path, data)
+  var csv = openCsvMap(path, separator = ';')
+  doAssert csv.len == data.len
+  let whole = rows(csv.chunk)
+  doAssert whole.len == 501
+  doAssert whole[1] == @["0", "name 0", "a; \"quoted\"\nnote\r\nover lines"]
+  for n in [1, 2, 3, 7, 64, 10_000]:
+    let parts = csv.chunks(n)
+    doAssert parts.len <= n
+    var joined: seq[seq[string]]
+    var size = 0
+    for c in parts:
+      joined.add rows(c)
+      size += c.len
+    doAssert size == data.len
+    doAssert joined == whole
+  csv.close()
+
+  writeFile(path, "")
+  csv = openCsvMap(path)
+  doAssert csv.chunks(4).len == 1
+  doAssert rows(csv.chunk).len == 0
+  csv.close()
+  removeFile(path)
+
+  try:
+    var r = initCsvReader(toCsvChunk("a\n\"b"))
+    discard r.readRow()
+    discard r.readRow()
+    doAssert false
+  except CsvError as e:
+    doAssert e.msg == "(2, 1) Error: \" expected"
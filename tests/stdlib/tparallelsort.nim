@@ -0,0 +1,44 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[parallelsort, algorithm, sequtils]
+import std/assertions
+
+proc byLen(x, y: string): int = cmp(x.len, y.len)
+
+block: # large inputs are sorted on several threads
+  for n in [0, 1, 5, 32_767, 100_003, 250_000]:
+    var a = newSeq[int](n)
+    for i in 0 ..< n: a[i] = (i * 7919) mod 100_019
+    var b = a
+    b.sort()
+    a.parallelSort()
+    doAssert a == b
+    a.parallelSort(Descending)
+    doAssert a == b.reversed
+
+block: # strings and custom comparisons, stable like sort
+  var a = newSeq[string](70_000)
+  for i in 0 ..< a.len: a[i] = $((i * 31) mod 9973)
+  var b = a
+  b.sort(byLen)
+  a.parallelSort(byLen)
+  doAssert a == b
+  a.parallelSort()
+  doAssert a.isSorted
+
+block: # parallelSortedByIt
+  type Item = tuple[key: int, index: int]
+  var data = newSeq[Item](80_000)
+  for i in 0 ..< data.len: data[i] = (i mod 17, i)
+  let res = data.parallelSortedByIt(it.key)
+  doAssert res == data.sortedByIt(it.key)
+  doAssert res.mapIt(it.key).isSorted
+  doAssert @["ccc", "a", "bb"].parallelSortedByIt(it.len) == @["a", "bb", "ccc"]
+
+static:
+  var a = @[3, 1, 2]
+  a.parallelSort()
+  doAssert a == @[1, 2, 3]
@@ -0,0 +1,37 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[json, strutils, streams]
+import std/assertions
+
+template fn() =
+  block: # strings with special characters at every offset of a word
+    for n in 0 .. 20:
+      for special in ["\"", "\\", "\n", "\r", "\t", "é", "\u{1F600}"]:
+        for at in 0 .. n:
+          let s = 'a'.repeat(at) & special & 'b'.repeat(n - at)
+          doAssert parseJson(escapeJson(s)).getStr == s
+          doAssert parseJson("[\"" & s.replace("\\", "\\\\").replace("\"", "\\\"") & "\"]")[0].getStr == s
+
+  block: # numbers
+    doAssert parseJson("[0, -12, 3.5, -.5, .25, 1e3, 2E-2, 12345678901234]") ==
+      %*[0, -12, 3.5, -0.5, 0.25, 1000.0, 0.02, 12345678901234]
+    doAssert parseJson("-0").kind == JInt
+    doAssert parseJson("1.0").kind == JFloat
+    doAssert parseJson("1e2").kind == JFloat
+
+static: fn()
+fn()
+
+block: # strings longer than the lexer buffer, with and without line breaks
+  let long = 'x'.repeat(20_000)
+  doAssert parseJson(newStringStream("\"" & long & "\"")).getStr == long
+  let lines = "ab\ncd\n".repeat(3000)
+  doAssert parseJson(newStringStream("\"" & lines & "\"")).getStr == lines
+  var n = 0
+  for x in parseJsonFragments(newStringStream(("{\"k\": \"" & long & "\"}\n").repeat(5))):
+    doAssert x["k"].getStr == long
+    inc n
+  doAssert n == 5
@@ -0,0 +1,127 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[jsonutils, json, options, tables, sets, strtabs, streams, strutils]
+import std/assertions
+
+type
+  Color = enum red, green, blue
+  Meters = distinct float
+  Inner = object
+    name: string
+    tags: seq[string]
+  Outer = object
+    id: int
+    ratio: float
+    color: Color
+    flag: bool
+    inner: Inner
+    refInner: ref Inner
+    maybe: Option[int]
+    table: Table[string, int]
+    hs: HashSet[int]
+    arr: array[2, uint8]
+    tup: (int, string)
+    named: tuple[a: int, b: char]
+    node: JsonNode
+    dist: Meters
+  Kind = enum kA, kB
+  Variant = object
+    case kind: Kind
+    of kA: a: int
+    of kB: b: string
+
+proc roundTrip[T](x: T, opt = Joptions()) =
+  # the streaming decoder agrees with `jsonTo`
+  let s = $toJson(x)
+  let direct = parseJsonTo[T](s, opt)
+  doAssert $toJson(direct) == s, $toJson(direct) & "\n" & s
+  doAssert $toJson(parseJson(s).jsonTo(T, opt)) == s
+
+block: # nested types
+  var o = Outer(id: 7, ratio: 1.5, color: blue, flag: true,
+                inner: Inner(name: "x", tags: @["a", "b"]),
+                maybe: some(3), table: {"k": 1}.toTable, hs: [4, 5].toHashSet,
+                arr: [1'u8, 255], tup: (2, "t"), named: (a: 1, b: 'z'),
+                node: %*{"free": [1, "form"]}, dist: Meters(2.5))
+  o.refInner = new Inner
+  o.refInner.name = "r"
+  roundTrip(o)
+  roundTrip(@[o, Outer(node: newJNull())])
+  roundTrip(Variant(kind: kB, b: "case"))
+  roundTrip(newStringTable("a", "b", modeCaseSensitive))
+  roundTrip([NaN, Inf, -Inf, 0.5])
+
+block: # field order, whitespace and escapes
+  let x = parseJsonTo[Inner]("""
+    { "tags" : [ "é", "q\"" ] ,
+      "name": "n\n" }""")
+  doAssert x.name == "n\n"
+  doAssert x.tags == @["é", "q\""]
+  doAssert parseJsonTo[seq[int]]("[]") == newSeq[int]()
+  doAssert parseJsonTo[string]("null") == ""
+  doAssert parseJsonTo[Color]("\"green\"") == green
+  doAssert parseJsonTo[Color]("2") == blue
+  doAssert parseJsonTo[uint64]("18446744073709551615") == high(uint64)
+  doAssert parseJsonTo[Option[string]]("null").isNone
+  doAssert parseJsonTo[Inner](newStringStream("""{"name":"s","tags":[]}""")).name == "s"
+
+block: # Joptions
+  type Guide = object
+    question: string
+    answer: int
+  let extra = """{"question":"6*9=?","answer":42,"author":{"name":"Douglas"}}"""
+  let missing = """{"answer":42}"""
+  doAssertRaises(ValueError): discard parseJsonTo[Guide](extra)
+  doAssertRaises(ValueError): discard parseJsonTo[Guide](missing)
+  doAssertRaises(ValueError):
+    discard parseJsonTo[Guide](extra, Joptions(allowMissingKeys: true))
+  doAssertRaises(ValueError):
+    discard parseJsonTo[Guide](missing, Joptions(allowExtraKeys: true))
+  doAssert parseJsonTo[Guide](extra, Joptions(allowExtraKeys: true)) ==
+    Guide(question: "6*9=?", answer: 42)
+  doAssert parseJsonTo[Guide](missing, Joptions(allowMissingKeys: true)) ==
+    Guide(answer: 42)
+
+block: # errors
+  doAssertRaises(JsonKindError): discard parseJsonTo[int]("\"1\"")
+  doAssertRaises(JsonKindError): discard parseJsonTo[seq[int]]("{}")
+  doAssertRaises(JsonKindError): discard parseJsonTo[Inner]("[]")
+  doAssertRaises(ValueError): discard parseJsonTo[array[2, int]]("[1]")
+  doAssertRaises(ValueError): discard parseJsonTo[array[2, int]]("[1, 2, 3]")
+  doAssertRaises(ValueError): discard parseJsonTo[(int, int)]("[0]")
+  doAssertRaises(JsonParsingError): discard parseJsonTo[seq[int]]("[1, 2")
+  doAssertRaises(JsonParsingError): discard parseJsonTo[int]("1 2")
+  doAssertRaises(JsonParsingError):
+    discard parseJsonTo[JsonNode]("[".repeat(2000) & "]".repeat(2000))
+  try:
+    discard parseJsonTo[Inner]("""{"name": 1, "tags": []}""")
+    doAssert false
+  except JsonKindError as e:
+    doAssert "Wanted '{JString, JNull}'" in e.msg, e.msg
+    doAssert "got 'JInt'" in e.msg, e.msg
+
+block: # key errors give the position of the object
+  type Guide = object
+    question: string
+    answer: int
+  proc errorOf(body: proc ()): string =
+    try:
+      body()
+      doAssert false
+    except ValueError as e:
+      result = e.msg
+  let extra = """{"question":"6*9=?","answer":42,"author":"Douglas"}"""
+  doAssert errorOf(proc () = discard parseJsonTo[Guide](extra)) ==
+    "input(1, 1) Error: There were 3 keys (expecting 2) for Guide"
+  doAssert errorOf(proc () =
+    discard parseJsonTo[seq[Guide]](newStringStream("[\n " & """{"answer":42}]"""), "f.json")) ==
+    "f.json(2, 2) Error: key 'question' for Guide not in object"
+
+block: # cstring would point into a freed tree
+  type C = object
+    c: cstring
+  doAssert not compiles(parseJsonTo[C]("""{"c": "x"}"""))
+  doAssert not compiles(parseJsonTo[cstring]("\"x\""))
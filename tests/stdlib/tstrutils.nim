@@ -905,6 +905,51 @@ bar
     doAssert "abc \0 def".find("def") == 6
     doAssert "abc \0 def".find('d') == 6
 
+  block: # find and multiReplace on inputs longer than a few words
+    let long = repeat("abcdefgh", 20) & "x,y\tz" & repeat("abcdefgh", 20)
+    doAssert long.find({',', '\t'}) == 161
+    doAssert long.find({'x', ',', '\t'}) == 160
+    doAssert long.find({'x', ',', '\t'}, 162) == 163
+    doAssert long.find({',', '\t'}, 0, 160) == -1
+    doAssert long.find({'Q'}) == -1
+    doAssert long.find({'\0'}) == -1
+    doAssert long.find("x,y") == 160
+    doAssert long.find("x,y", 0, 161) == -1
+    doAssert long.find("x,y", 0, 162) == 160
+    doAssert long.find("ha", 155) == 172
+    doAssert long.find("hgh") == -1
+    doAssert long.multiReplace((",", ";"), ("\t", " ")).find("x;y z") == 160
+    doAssert long.split({',', '\t'}).len == 3
+    doAssert long.find({'x', ','}, 0, long.high) == 160
+    doAssertRaises(IndexDefect): discard long.find({'Q'}, 0, long.len + 20)
+    doAssertRaises(IndexDefect): discard long.find({'Q', 'R'}, 300, long.len)
+
+  block: # MultiSearcher
+    let m = initMultiSearcher(["he", "she", "his", "hers", "", "he"])
+    var found: seq[(int, int)]
+    for x in m.findAll("ahishers"):
+      found.add x
+    doAssert found == @[(2, 1), (1, 3), (0, 4), (5, 4), (3, 4)]
+    found.setLen 0
+    for x in m.findAll("ahishers", 4):
+      found.add x
+    doAssert found == @[(0, 4), (5, 4), (3, 4)]
+    doAssert m.find("xx his") == (pattern: 2, first: 3)
+    doAssert m in "ahis"
+    doAssert m notin "xyz"
+    doAssert m notin ""
+    doAssert initMultiSearcher([]) notin "xyz"
+    var empty: MultiSearcher
+    doAssert empty notin "xyz"
+
+    let words = ["error", "warn", "fatal", "panic"]
+    let ms = initMultiSearcher(words)
+    let log = repeat("info: all good; ", 50) & "fatal: disk full; warning" & repeat(" ok", 30)
+    var hits: seq[string]
+    for x in ms.findAll(log):
+      hits.add log[x.first ..< x.first + words[x.pattern].len]
+    doAssert hits == @["fatal", "warn"]
+
 
 static: main()
 main()
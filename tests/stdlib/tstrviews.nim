@@ -0,0 +1,77 @@
+discard """
+  matrix: "--mm:refc; --mm:orc"
+  targets: "c cpp"
+"""
+
+import std/[strviews, strutils, tables, hashes, algorithm, sequtils]
+import std/assertions
+
+proc collect(s: string, sep: char | set[char] | string, maxsplit = -1): seq[string] =
+  for x in splitView(s, sep, maxsplit): result.add $x
+
+block: # split iterators match strutils
+  for s in ["", ",", "a", "a,b", ",a,,b,", "abc,,def,ghi,,,"]:
+    doAssert collect(s, ',') == s.split(',')
+    doAssert collect(s, ',', 1) == s.split(',', 1)
+    doAssert collect(s, {',', 'b'}) == s.split({',', 'b'})
+    doAssert collect(s, ",,") == s.split(",,")
+  for s in ["", "  ", " a  b\tc ", "a\nb", "x"]:
+    var words: seq[string]
+    for w in splitWhitespaceView(s): words.add $w
+    doAssert words == s.splitWhitespace
+    words.setLen 0
+    for w in splitWhitespaceView(s, 1): words.add $w
+    doAssert words == s.splitWhitespace(1)
+  for s in ["", "\n", "a\r\nb\rc\n\nd", "x\n", "\r\r\n"]:
+    for keepEol in [false, true]:
+      var lines: seq[string]
+      for line in splitLinesView(s, keepEol): lines.add $line
+      doAssert lines == s.splitLines(keepEol), s.escape
+
+block: # views of views and other memory
+  let s = "id\tname\tscore"
+  var fields: seq[StrView]
+  for f in s.splitView('\t'): fields.add f
+  doAssert fields[1] == "name" and "name" == fields[1]
+  doAssert fields[1].len == 4 and fields[1][0] == 'n' and fields[1][^1] == 'e'
+  doAssert fields[2][1 .. 2] == "co"
+  doAssert fields[0] < fields[1] and fields[1] <= fields[1]
+  doAssert cmp(fields[2], "score") == 0 and cmp(fields[0], "idx") < 0
+  doAssert fields[2].startsWith("sc") and fields[2].endsWith("ore")
+  doAssert not fields[0].startsWith("idx")
+  var inner: seq[string]
+  for f in splitView(toOpenArray(fields[2]), 'c'): inner.add $f
+  doAssert inner == @["s", "ore"]
+  var t: string
+  t.add fields[0]
+  t.add fields[1]
+  doAssert t == "idname"
+  doAssertRaises(IndexDefect): discard fields[0][2]
+  let raw = toStrView(unsafeAddr s[3], 4)
+  doAssert raw == "name"
+  doAssert toStrView(" \t x \n").strip == "x"
+  doAssert toStrView("  ").strip.len == 0
+  doAssert toStrView("").len == 0
+
+block: # parsing, hashing and sorting
+  let line = "-42, 18446744073709551615 ,3.25,inf,x"
+  var v: seq[StrView]
+  for f in line.splitView(','): v.add f.strip
+  doAssert parseInt(v[0]) == -42
+  doAssert parseBiggestInt(v[0]) == -42
+  doAssert parseUInt(v[1]) == high(uint)
+  doAssert parseFloat(v[2]) == 3.25
+  doAssert parseFloat(v[3]) == Inf
+  doAssertRaises(ValueError): discard parseInt(v[4])
+  doAssertRaises(ValueError): discard parseFloat(v[4])
+  doAssertRaises(ValueError): discard parseInt(toStrView(""))
+
+  let text = "b a c a b a"
+  var counts: Table[StrView, int]
+  for w in text.splitWhitespaceView: counts.mgetOrPut(w, 0).inc
+  doAssert counts[toStrView("a")] == 3 and counts[toStrView("c")] == 1
+  doAssert hash(toStrView("abc")) == hash("abc")
+  var words: seq[StrView]
+  for w in text.splitWhitespaceView: words.add w
+  words.sort(cmp)
+  doAssert words.mapIt($it) == @["a", "a", "a", "b", "b", "c"]
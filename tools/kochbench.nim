@@ -0,0 +1,133 @@
+## Part of 'koch' responsible for `koch benchcompiler`: compiles a fixed corpus
+## of programs with `--profileCompiler`, takes the phase times, peak memory
+## and counters from the traces and compares them with a stored baseline.
+
+import std/[os, strutils, osproc, json, parseopt, monotimes, times, tables]
+
+import kochdocs
+
+when defined(nimPreviewSlimSystem):
+  import std/syncio
+
+const
+  corpusDir = "tests/benchmarks/compiler"
+  corpus = ["bstdlib", "bgenerics", "bmacros", "bgenerated"]
+  defaultBaseline = "testresults/benchcompiler.json"
+  timeMetrics = ["total ms", "sem ms", "cgen ms"]
+  metrics = ["total ms", "sem ms", "cgen ms", "peak memory",
+             "VM instructions", "generic instantiations"]
+
+proc generatedModule(): string =
+  ## A large module like the ones produced by wrapper and code generators:
+  ## many types, enums and procs with long `case` statements.
+  result = "# generated by `koch benchcompiler`\n\n"
+  for i in 0 ..< 1500:
+    result.add "type\n  Obj$1* = object\n    a*: int\n    b*: string\n    c*: seq[float]\n  Kind$1* = enum\n" % $i
+    for k in 0 ..< 12: result.add "    k$1v$2\n" % [$i, $k]
+    result.add "\nproc handle$1*(o: var Obj$1; k: Kind$1): int =\n  case k\n" % $i
+    for k in 0 ..< 12:
+      result.add "  of k$1v$2:\n    o.a += $2\n    o.b.add \"$2\"\n    o.c.add $2.0\n" % [$i, $k]
+    result.add "  result = o.a + o.b.len + o.c.len\n\n"
+  result.add "var total = 0\n"
+  for i in 0 ..< 1500:
+    result.add "block:\n  var o = Obj$1()\n  for k in Kind$1: total += handle$1(o, k)\n" % $i
+  result.add "echo total\n"
+
+proc measure(program, workDir: string; extraArgs: string): Table[string, float] =
+  ## Compiles `program` once and returns its metrics.
+  let trace = workDir / program & ".json"
+  let file = (if program == "bgenerated": workDir else: corpusDir) / program & ".nim"
+  let cmd = "$1 c --compileOnly --hints:off --warnings:off --nimcache:$2 --profileCompiler:$3 $4 $5" % [
+    findNim().quoteShell, quoteShell(workDir / program), quoteShell(trace),
+    extraArgs, quoteShell(file)]
+  let start = getMonoTime()
+  let (output, exitCode) = execCmdEx(cmd)
+  let wall = getMonoTime() - start
+  if exitCode != 0:
+    echo output
+    quit "FAILURE: " & cmd
+  let data = parseFile(trace)["otherData"]
+  proc ms(phases: varargs[string]): float =
+    result = 0.0
+    for p in phases: result += data[p & " ms"].getFloat
+  result = {"total ms": wall.inNanoseconds.float / 1e6,
+            "sem ms": ms("sem", "instantiate", "macro"),
+            "cgen ms": ms("codegen", "transf", "injectdestructors"),
+            "peak memory": data["peak memory"].getFloat,
+            "VM instructions": data["VM instructions"].getFloat,
+            "generic instantiations": data["generic instantiations"].getFloat}.toTable
+
+proc formatMetric(metric: string; x: float): string =
+  if metric == "peak memory": formatSize(x.int64)
+  elif metric in timeMetrics: formatFloat(x, ffDecimal, 1)
+  else: $x.int64
+
+proc benchCompiler*(args: string) =
+  ## Runs the corpus `runs` times and keeps the minimum of every metric, as
+  ## the least disturbed measurement. Regressions beyond `threshold` percent
+  ## of the baseline make koch fail.
+  var
+    runs = 3
+    threshold = 10.0
+    baselineFile = defaultBaseline
+    save = false
+    extraArgs = ""
+  var op = initOptParser(args)
+  for kind, key, val in op.getopt():
+    case kind
+    of cmdLongOption, cmdShortOption:
+      case normalize(key)
+      of "runs": runs = max(1, parseInt(val))
+      of "threshold": threshold = parseFloat(val)
+      of "baseline": baselineFile = val
+      of "save": save = true
+      else:
+        # passed on to the compiler, e.g. `-d:nimPreviewSlimSystem`
+        let prefix = if kind == cmdShortOption: "-" else: "--"
+        extraArgs.add " " & quoteShell(
+          if val.len > 0: prefix & key & ":" & val else: prefix & key)
+    of cmdArgument: quit "unexpected argument: " & key
+    of cmdEnd: discard
+
+  let workDir = getTempDir() / "nim_benchcompiler"
+  createDir(workDir)
+  writeFile(workDir / "bgenerated.nim", generatedModule())
+
+  var results = newJObject()
+  for program in corpus:
+    var best = initTable[string, float]()
+    for run in 0 ..< runs:
+      for metric, x in measure(program, workDir, extraArgs):
+        best[metric] = if run == 0: x else: min(best[metric], x)
+    results[program] = newJObject()
+    for metric in metrics: results[program][metric] = %best[metric]
+
+  let baseline = if fileExists(baselineFile): parseFile(baselineFile) else: nil
+  var regressions = 0
+  echo alignLeft("program", 12), alignLeft("metric", 24), align("baseline", 12),
+    align("current", 12), align("change", 10)
+  for program in corpus:
+    for metric in metrics:
+      let x = results[program][metric].getFloat
+      var line = alignLeft(program, 12) & alignLeft(metric, 24)
+      if baseline != nil and baseline.hasKey(program) and
+          baseline[program].hasKey(metric):
+        let old = baseline[program][metric].getFloat
+        let change = if old > 0: (x / old - 1) * 100 else: 0.0
+        line.add align(formatMetric(metric, old), 12) &
+          align(formatMetric(metric, x), 12) &
+          align(formatFloat(change, ffDecimal, 1) & "%", 10)
+        if change > threshold:
+          line.add "  REGRESSION"
+          inc regressions
+      else:
+        line.add align("-", 12) & align(formatMetric(metric, x), 12)
+      echo line
+
+  if save or baseline == nil:
+    createDir(baselineFile.parentDir)
+    writeFile(baselineFile, results.pretty)
+    echo "baseline written to ", baselineFile
+  if regressions > 0 and not save:
+    quit "FAILURE: " & $regressions & " metrics regressed by more than " &
+      formatFloat(threshold, ffDecimal, 1) & "%"